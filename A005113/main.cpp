@@ -7,17 +7,18 @@
 std::set<uint64_t> primes_in_class[20];
 
 constexpr size_t Prime_N = 1'00'000'000;
-PrimeSieve<Prime_N> primeFact;
+CompactPrimeSieve<Prime_N> primeFact{prime::CacheFile{}};
 
 int get_prime_class(size_t p)
 {
-  static std::unordered_map<size_t, int> cache;
+  // every prime below Prime_N ends up here, size it once instead of rehashing ~20 times
+  static std::unordered_map<size_t, int> cache(prime::pi(Prime_N));
 
   if (p <= 3) return 0;
   if (cache.count(p)) return cache[p];
 
   int max_factor_class = 0;
-  for (const auto& [q, freq] : primeFact.vector_factors_freq(p + 1))
+  for (const auto& [q, freq] : primeFact.small_factors_freq(p + 1))
   {
     max_factor_class = std::max(max_factor_class, get_prime_class(q));
   }
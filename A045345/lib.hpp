@@ -9,20 +9,13 @@ namespace A045345 {
 template <int N> std::vector<int> answers_upto()
 {
   std::vector<int> answers;
-  PrimeSieve<N> p;
-  auto primes = p.all_primes();
-  std::vector<BigInt> sum(primes.size());
-  for (size_t i = 1; i < primes.size(); i++)
+  BigInt sum = 0; // sum of the first i primes
+  int i      = 0;
+  for (uint64_t p : PrimeRange(0, N + 1))
   {
-    sum[i] = sum[i - 1] + primes[i - 1];
-  }
-
-  for (size_t i = 1; i < sum.size(); i++)
-  {
-    if (sum[i] % i == 0)
-    {
-      answers.push_back(i);
-    }
+    if (i > 0 && sum % i == 0) answers.push_back(i);
+    sum += p;
+    i++;
   }
   return answers;
 }
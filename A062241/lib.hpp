@@ -1,63 +1,38 @@
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <cstdint>
 #include <utils/Prime.hpp>
+#include <utils/Sumset.hpp>
 #include <vector>
 
-template <int N> struct DataHelper
+// n in [0, N) with largest prime factor exactly p, 0 and 1 count as part of the 2 group
+inline void for_each_with_highest_prime(const SmoothNumbers& smooth, uint64_t p, auto callback)
 {
-public:
-  DataHelper() : mHighestPrimeDiv(N, 1)
+  if (p == 2)
   {
-    mHighestPrimeDiv[0] = 1;
-    mHighestPrimeDiv[1] = 1;
-    mGroupByHighestDiv[2].push_back(0);
-    mGroupByHighestDiv[2].push_back(1);
-
-    for (int i = 2; i < N; ++i)
-    {
-      int p               = mPrime.highest_prime_factor(i);
-      mHighestPrimeDiv[i] = p;
-      mGroupByHighestDiv[p].push_back(i);
-    }
-  }
-
-  const PrimeSieve<N>& prime() const { return mPrime; }
-  const std::vector<int>& highestPrimeDiv() const { return mHighestPrimeDiv; }
-  const std::map<int, std::vector<int>>& groupByHighestDiv() const { return mGroupByHighestDiv; }
-
-private:
-  PrimeSieve<N> mPrime;
-  std::vector<int> mHighestPrimeDiv;
-  std::map<int, std::vector<int>> mGroupByHighestDiv;
-};
-
-inline bool has_sum(const std::vector<char>& active, int target)
-{
-  for (int j = 0; j <= target / 2; j++)
-  {
-    if (active[j] && active[target - j]) return true;
+    callback(0);
+    callback(1);
   }
-  return false;
+  smooth.for_each_with_largest(p, callback);
 }
 
-inline size_t bruteforce_answer(const std::vector<char>& active)
+inline size_t bruteforce_answer(const SumsetEngine& active)
 {
   for (size_t i = 0; i < active.size(); i++)
   {
-    if (!has_sum(active, i)) return i;
+    if (!active.has_sum(i)) return i;
   }
   return -1;
 }
 
-template <int N>
-int find_answer(const DataHelper<N>& data, size_t P, int lower_bound, const std::vector<char>& active)
+inline int find_answer(const SmoothNumbers& smooth, size_t P, int lower_bound, const SumsetEngine& active)
 {
   const int n = active.size();
 
   int first_chunk_size = 0;
   for (int i = 0; i < n; i++)
-    if (!active[i])
+    if (!active.test(i))
     {
       first_chunk_size = i;
       break;
@@ -66,11 +41,11 @@ int find_answer(const DataHelper<N>& data, size_t P, int lower_bound, const std:
   int cand = std::max(2 * first_chunk_size + 1, lower_bound);
   while (cand < n)
   {
-    if (active[cand])
+    if (active.test(cand))
       cand += first_chunk_size;
-    else if (data.prime().lowest_prime_factor(cand) <= P)
+    else if (std::ranges::any_of(smooth.primes(), [&](uint64_t q) { return q <= P && cand % q == 0; }))
       cand++;
-    else if (has_sum(active, cand))
+    else if (active.has_sum(cand))
       cand++;
     else
       return cand;
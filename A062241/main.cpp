@@ -1,7 +1,7 @@
 #include <A062241/lib.hpp>
-#include <utils/Fft.hpp>
 #include <utils/MetaProg.hpp>
 #include <utils/Prime.hpp>
+#include <utils/Sumset.hpp>
 #include <utils/Utils.hpp>
 
 // a(n) is the smallest k such that n = a + b where a and b are not divisible by any prime > k
@@ -16,19 +16,19 @@ int main()
   {
     utils::ScopeTimer _t{};
 
-    DataHelper<N> data{};
-    std::vector<char> active(N, 0);
+    const SmoothNumbers smooth(N - 1, K);
+    SumsetEngine active(N);
+    const auto activate = [&](uint64_t x) { active.set(x); };
     mp::For<2, M>([&](auto k)
     {
-      if (data.prime().is_prime(k))
-        for (int x : data.groupByHighestDiv().at(k)) active[x] = 1;
+      if (maya::is_prime(k)) for_each_with_highest_prime(smooth, k, activate);
     });
     mp::For<M, K>([&](auto k)
     {
-      if (data.prime().is_prime(k))
+      if (maya::is_prime(k))
       {
-        for (int x : data.groupByHighestDiv().at(k)) active[x] = 1;
-        int answer = find_answer(data, k, lower_bound, active);
+        for_each_with_highest_prime(smooth, k, activate);
+        int answer = find_answer(smooth, k, lower_bound, active);
         Log(LL::Info, k, answer);
         lower_bound = answer;
       }
@@ -43,25 +43,26 @@ int main()
   {
     utils::ScopeTimer _t{};
 
-    DataHelper<N> data{};
-    std::vector<size_t> active(N, 0);
+    const SmoothNumbers smooth(N - 1, K);
+    SumsetCounter sums(N, N); // exact pair counts, updated by each prime's new numbers only
+    std::vector<uint64_t> added;
+    const auto activate = [&](uint64_t x) { added.push_back(x); };
 
     mp::For<2, M>([&](auto k)
     {
-      if (data.prime().is_prime(k))
-        for (int x : data.groupByHighestDiv().at(k)) active[x] = 1;
+      if (maya::is_prime(k)) for_each_with_highest_prime(smooth, k, activate);
     });
+    sums.insert(added);
 
     mp::For<M, K>([&](auto k)
     {
-      if (data.prime().is_prime(k))
+      if (maya::is_prime(k))
       {
-        for (int x : data.groupByHighestDiv().at(k)) active[x] = 1;
-        Log(LL::Info, active);
-        auto C = fft::round<size_t>(fft::self_convolution(active));
-        Log(LL::Info, C);
-        auto it    = std::find(C.begin() + 2, C.begin() + N, 0);
-        int answer = (it == C.begin() + N) ? -1 : std::distance(C.begin(), it);
+        added.clear();
+        for_each_with_highest_prime(smooth, k, activate);
+        sums.insert(added);
+        const auto zero = sums.first_zero(2);
+        int answer      = zero ? static_cast<int>(*zero) : -1;
         std::cout << k << ' ' << answer << std::endl;
       }
     });
@@ -17,7 +17,7 @@ template <size_t Bound_, typename ValueT> struct PrimeVector
   explicit PrimeVector(ValueT defaultVal = ValueT{})
   {
     uint32_t rank = 0;
-    PrimeSieve<Bound> sieve;
+    CompactPrimeSieve<Bound> sieve{prime::CacheFile{}};
     for (uint64_t p : sieve.all_primes()) mRank[p] = rank++;
     mData.assign(rank, defaultVal);
   }
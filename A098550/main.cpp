@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <numbers>
+#include <optional>
 #include <span>
 #include <vector>
 
@@ -11,7 +13,6 @@
 #include <utils/Logging.hpp>
 #include <utils/Prime.hpp>
 #include <utils/Utils.hpp>
-#include <utils/maya/Prime.hpp>
 
 struct OptUint64
 {
@@ -44,9 +45,11 @@ struct ConjectureChecker
 
     if (a == n && n > 100) reportBreach("New fixed point: n=$"_f, n);
 
-    if (maya::is_prime(a))
+    if (a >= mPrimes.limit()) mPrimes.extend(std::max(a + 1, mPrimes.limit() * 3 / 2));
+
+    if (mPrimes.is_prime(a))
     {
-      uint64_t nextExpected = next_prime(mLastPrime);
+      uint64_t nextExpected = nextPrime(mLastPrime);
       if (a != nextExpected)
         reportBreach("Conj8 broken at n=$: a(n)=$ skipping over a prime $"_f, n, a, nextExpected);
 
@@ -65,13 +68,13 @@ struct ConjectureChecker
   }
 
 private:
-  static uint64_t next_prime(uint64_t p)
+  // covering a is not enough: a prime term below the one after mLastPrime is the Conj8 breach itself,
+  // so grow until that next prime is inside the bitmap
+  uint64_t nextPrime(uint64_t p)
   {
-    if (p < 2) return 2;
-    if (p == 2) return 3;
-    uint64_t c = p + 2;
-    while (!maya::is_prime(c)) c += 2;
-    return c;
+    std::optional<uint64_t> next;
+    while (!(next = mPrimes.find_next_prime(p))) mPrimes.extend(std::max(p + 30, mPrimes.limit() * 3 / 2));
+    return *next;
   }
 
   template <typename... Args> static void reportBreach(Args&&... args)
@@ -81,6 +84,7 @@ private:
   }
 
   RingBuffer<8> mHistory;
+  PrimeBitmap mPrimes;
   uint64_t mLastPrime = 0;
 };
 
@@ -156,15 +160,21 @@ private:
     mNextIndex++;
     mPrev2        = mPrev1;
     mPrev1        = x;
-    mPrev2Factors = std::move(mPrev1Factors);
-    mPrev1Factors = mSieve.distinct_factors(x);
+    // swap + refill keeps both buffers' capacity, so placing a term never allocates
+    std::swap(mPrev2Factors, mPrev1Factors);
+    mPrev1Factors.clear();
+    mSieve.emit_factors(x, [&](uint64_t p)
+    {
+      if (mPrev1Factors.empty() || mPrev1Factors.back() != p) mPrev1Factors.push_back(p);
+    });
     mFilter.markUsed(x);
     mFilter.mustCoprimeTo(mPrev1Factors);
     return x;
   }
 
   CandidateFilter mFilter;
-  PrimeSieve<kSieveBound> mSieve;
+  // grows with the terms up to kSieveBound, Pollard-Brent past it
+  DynamicPrimeSieve mSieve{DynamicPrimeSieve::cFirstBlock, kSieveBound};
   std::vector<uint64_t> mPrev2Factors, mPrev1Factors;
   uint64_t mPrev2 = 0, mPrev1 = 0;
   uint64_t mNextIndex = 1;
@@ -1,9 +1,10 @@
 #include <cstdint>
+#include <span>
 #include <utils/Prime.hpp>
 #include <utils/PrimeInt.hpp>
 #include <utils/Utils.hpp>
 
-PrimeSieve<5000000> p;
+PrimeSieve<5000000> p{prime::CacheFile{}};
 
 // prime: 3^2 = 9           -> 1 8
 // prime: 7^2 = 49          -> 2 48
@@ -18,9 +19,10 @@ PrimeSieve<5000000> p;
 
 struct MaxPrime
 {
-  size_t maxP, mult;
+  size_t maxP = 0, mult = 0;
 
-  MaxPrime(std::vector<std::pair<size_t, size_t>> factors)
+  MaxPrime() = default;
+  MaxPrime(std::span<const std::pair<uint64_t, uint64_t>> factors)
   {
     maxP = factors.back().first;
     mult = factors.back().second;
@@ -44,10 +46,11 @@ void print_from_start(size_t start, size_t width)
     Log(LL::Info, "$ == $"_f, i, PrimeInt(p.vector_factors_freq(i)));
 }
 
-bool is_valid_start(size_t start, size_t width)
+// window must cover [start, start + width]
+bool is_valid_start(const FactorWindow& window, size_t start, size_t width)
 {
-  MaxPrime prod({{0, 0}});
-  for (size_t i = start; i <= start + width; i++) prod *= MaxPrime(p.vector_factors_freq(i));
+  MaxPrime prod;
+  for (size_t i = start; i <= start + width; i++) prod *= MaxPrime(window.factors(i));
 
   return prod.mult >= 2;
 }
@@ -60,7 +63,7 @@ void find_short_sequence()
     while (u++)
     {
       uint64_t v = u + distance;
-      MaxPrime prod({{0, 0}});
+      MaxPrime prod;
       for (uint64_t i = u; i <= v; i++) prod *= MaxPrime(p.vector_factors_freq(i));
       if (prod.mult >= 2)
       {
@@ -80,13 +83,14 @@ void find_upper_bound(size_t width)
     if (prime < width) continue;
 
     uint64_t psqr = prime * prime;
+    FactorWindow window(psqr - width, psqr + width + 1, p.all_primes());
 
     for (uint64_t start = psqr - width; start <= psqr; ++start)
     {
       bool found = true;
       for (size_t i = 0; i <= width; ++i)
       {
-        if (p.factors(start + i).back() > prime)
+        if (window.highest_prime_factor(start + i) > prime)
         {
           found = false;
           break;
@@ -97,7 +101,7 @@ void find_upper_bound(size_t width)
       {
         Log(LL::Info, "Prime $"_f, prime);
         print_from_start(start, width);
-        if (is_valid_start(start, width)) Log(LL::Info, width, start);
+        if (is_valid_start(window, start, width)) Log(LL::Info, width, start);
         return; // or width ++ to continue the search
       }
     }
@@ -110,28 +114,32 @@ void upper_bound_cert()
     size_t start = 4'928'180'396;
     size_t width = 9;
     // print_from_start(start, width);
-    if (is_valid_start(start, width) && !is_valid_start(start, width + 1))
+    FactorWindow window(start, start + width + 2, p.all_primes()); // one window for both checks
+    if (is_valid_start(window, start, width) && !is_valid_start(window, start, width + 1))
       Log(LL::Info, "$ confirmed"_f, width);
   }
   {
     size_t start = 40'533'366'231;
     size_t width = 10;
     // print_from_start(start, width);
-    if (is_valid_start(start, width) && !is_valid_start(start, width + 1))
+    FactorWindow window(start, start + width + 2, p.all_primes()); // one window for both checks
+    if (is_valid_start(window, start, width) && !is_valid_start(window, start, width + 1))
       Log(LL::Info, "$ confirmed"_f, width);
   }
   {
     size_t start = 111'460'496'439;
     size_t width = 11;
     // print_from_start(start, width);
-    if (is_valid_start(start, width) && !is_valid_start(start, width + 1))
+    FactorWindow window(start, start + width + 2, p.all_primes()); // one window for both checks
+    if (is_valid_start(window, start, width) && !is_valid_start(window, start, width + 1))
       Log(LL::Info, "$ confirmed"_f, width);
   }
   {
     size_t start = 436'502'026'483;
     size_t width = 12;
     // print_from_start(start, width);
-    if (is_valid_start(start, width) && !is_valid_start(start, width + 1))
+    FactorWindow window(start, start + width + 2, p.all_primes()); // one window for both checks
+    if (is_valid_start(window, start, width) && !is_valid_start(window, start, width + 1))
       Log(LL::Info, "$ confirmed"_f, width);
   }
 }
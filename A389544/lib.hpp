@@ -73,7 +73,12 @@ public:
     seqSize = 1;
   }
 
-  PrimeInt toPrimeInt(uint64_t n) const { return primeFactorizer.vector_factors_freq(n); }
+  // factor on the stack, then hand PrimeInt a single exact-size allocation
+  PrimeInt toPrimeInt(uint64_t n) const
+  {
+    auto freq = primeFactorizer.small_factors_freq(n);
+    return std::vector<std::pair<uint64_t, uint64_t>>(freq.begin(), freq.end());
+  }
 
   bool has_duplicate_product_cache(const BigInt& targetProduct) const
   {
@@ -284,7 +289,7 @@ private:
 
 public:
   std::set<BigInt> consecCache = std::set<BigInt>();
-  PrimeSieve<N> primeFactorizer{};
+  PrimeSieve<N> primeFactorizer{prime::ParallelBuild{}};
 
   Vector seq{};
   size_t seqSize = 0;
@@ -3,8 +3,8 @@
 #include <algorithm>
 #include <cstdint>
 #include <random>
-#include <unordered_map>
 #include <utils/GeneticAlg.hpp>
+#include <utils/Sumset.hpp>
 #include <vector>
 
 template <int N> class Gene
@@ -65,27 +65,17 @@ public:
 private:
   void _calculate_score()
   {
-    std::vector<int> A, B;
-    for (size_t i = 0; i < mMask.size(); i++)
-    {
-      if (mMask[i])
-        A.push_back(i + 1);
-      else
-        B.push_back(i + 1);
-    }
+    // A = mask, B = the rest; differences don't see the +1 shift to {1..2N}
+    SumsetEngine A(mMask.size()), B(mMask.size());
+    for (size_t i = 0; i < mMask.size(); i++) (mMask[i] ? A : B).set(i);
 
     mMaxCount = 0;
-
-    // very unefficient. profiling do like above
-    std::unordered_map<int, uint64_t> cnt;
-    for (int a : A)
-      for (int b : B) mMaxCount = std::max(mMaxCount, ++cnt[a - b]);
-
-    std::unordered_map<uint64_t, uint64_t> cnt2;
-    for (auto [x, c] : cnt) cnt2[c]++;
-
-    mScore = 0;
-    for (auto [d, c] : cnt2) mScore += d * d * c;
+    mScore    = 0;
+    for (uint64_t c : A.difference_counts(B))
+    {
+      mMaxCount = std::max(mMaxCount, c);
+      mScore += c * c;
+    }
     mScore *= mMaxCount;
   }
 
@@ -0,0 +1,163 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <utils/Fft.hpp>
+#include <utils/Ntt.hpp>
+#include <utils/Poly.hpp>
+#include <utils/Recurrence.hpp>
+
+// 0/1 vectors, the shape A062241's sumset convolutions have
+static std::vector<size_t> random_bits(size_t n)
+{
+  std::mt19937 rng(1);
+  std::vector<size_t> v(n);
+  for (auto& x : v) x = rng() % 2;
+  return v;
+}
+
+static void BM_fft_self_convolution(benchmark::State& state)
+{
+  const auto v = random_bits(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(fft::round<size_t>(fft::self_convolution(v)));
+}
+
+// the same data pushed through complex transforms, as every call did before the real path
+static void BM_fft_self_convolution_complex(benchmark::State& state)
+{
+  const auto bits = random_bits(state.range(0));
+  const std::vector<fft::cd> v(bits.begin(), bits.end());
+  for (auto _ : state) benchmark::DoNotOptimize(fft::round<size_t>(fft::self_convolution(v)));
+}
+
+static void BM_ntt_self_convolution(benchmark::State& state)
+{
+  const auto v = random_bits(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(ntt::self_convolution(v));
+}
+
+// 40-bit coefficients: complex<double> can't do these exactly, the ntt takes all three primes
+static void BM_ntt_convolution_wide(benchmark::State& state)
+{
+  std::mt19937_64 rng(2);
+  std::vector<uint64_t> a(state.range(0)), b(state.range(0));
+  for (auto& x : a) x = rng() >> 24;
+  for (auto& x : b) x = rng() >> 24;
+  for (auto _ : state) benchmark::DoNotOptimize(ntt::convolution(a, b));
+}
+
+// the same 40-bit inputs through 16-bit limbs in doubles
+static void BM_fft_exact_convolution_wide(benchmark::State& state)
+{
+  std::mt19937_64 rng(2);
+  std::vector<uint64_t> a(state.range(0)), b(state.range(0));
+  for (auto& x : a) x = rng() >> 24;
+  for (auto& x : b) x = rng() >> 24;
+  for (auto _ : state) benchmark::DoNotOptimize(fft::exact_convolution(a, b));
+}
+
+// what every transform paid before plans were cached
+static void BM_fft_transform_fresh_plan(benchmark::State& state)
+{
+  std::vector<fft::cd> v(state.range(0), 1);
+  for (auto _ : state) fft::FftPlan(v.size()).execute<fft::Direction::Forward>(v);
+}
+
+static void BM_fft_transform_cached_plan(benchmark::State& state)
+{
+  std::vector<fft::cd> v(state.range(0), 1);
+  for (auto _ : state) fft::transform<fft::Direction::Forward>(v);
+}
+
+// one cached plan run at each kernel width the CPU has
+static void BM_fft_transform_simd(benchmark::State& state)
+{
+  const auto simd = static_cast<fft::Simd>(state.range(1));
+  if (simd > fft::best_simd())
+  {
+    state.SkipWithError("kernel width not supported here");
+    return;
+  }
+  std::vector<fft::cd> v(state.range(0), 1);
+  const auto p = fft::plan(v.size());
+  state.SetLabel(std::string(fft::to_string(simd)));
+  for (auto _ : state) p->execute<fft::Direction::Forward>(v, simd);
+}
+
+// sizes past L3 through one in-cache radix pass sequence, and through the four-step split
+static void BM_fft_transform_large_direct(benchmark::State& state)
+{
+  std::vector<fft::cd> v(state.range(0), 1);
+  const fft::FftPlan p(v.size(), SIZE_MAX);
+  for (auto _ : state) p.execute<fft::Direction::Forward>(v);
+}
+
+static void BM_fft_transform_large_four_step(benchmark::State& state)
+{
+  std::vector<fft::cd> v(state.range(0), 1);
+  const fft::FftPlan p(v.size(), 1);
+  for (auto _ : state) p.execute<fft::Direction::Forward>(v);
+}
+
+// generating-function work: exp of a series, and m values of a degree m polynomial
+static void BM_poly_exp(benchmark::State& state)
+{
+  using M = ModInt<998244353>;
+  std::mt19937 rng(4);
+  std::vector<M> c(state.range(0));
+  for (auto& x : c) x = M(rng());
+  c[0] = M(0);
+  const Poly<M> f(std::move(c));
+  for (auto _ : state) benchmark::DoNotOptimize(f.exp(f.size()));
+}
+
+static void BM_poly_evaluate(benchmark::State& state)
+{
+  using M = ModInt<998244353>;
+  std::mt19937 rng(5);
+  std::vector<M> c(state.range(0)), points(state.range(0));
+  for (auto& x : c) x = M(rng());
+  for (auto& x : points) x = M(rng());
+  const Poly<M> f(std::move(c));
+  for (auto _ : state) benchmark::DoNotOptimize(f.evaluate(points));
+}
+
+// the 10^18-th term of an order d recurrence
+static void BM_recurrence_nth(benchmark::State& state)
+{
+  using Rec = LinearRecurrence<ntt::cPrimes[0], ntt::cPrimes[1]>;
+  std::mt19937 rng(6);
+  std::vector<Rec::M> initial(state.range(0)), coeffs(state.range(0));
+  for (auto& x : initial) x = Rec::M(rng());
+  for (auto& x : coeffs) x = Rec::M(rng());
+  const Rec rec(std::move(initial), std::move(coeffs));
+  for (auto _ : state) benchmark::DoNotOptimize(rec.nth(1'000'000'000'000'000'000));
+}
+
+BENCHMARK(BM_fft_transform_fresh_plan)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_fft_transform_cached_plan)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_fft_transform_simd)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {0, 1, 2}});
+BENCHMARK(BM_fft_transform_large_direct)
+    ->RangeMultiplier(4)
+    ->Range(1 << 20, 1 << 24)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_fft_transform_large_four_step)
+    ->RangeMultiplier(4)
+    ->Range(1 << 20, 1 << 24)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_fft_self_convolution)->RangeMultiplier(8)->Range(1 << 12, 1 << 21)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_fft_self_convolution_complex)
+    ->RangeMultiplier(8)
+    ->Range(1 << 12, 1 << 21)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ntt_self_convolution)->RangeMultiplier(8)->Range(1 << 12, 1 << 21)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ntt_convolution_wide)->RangeMultiplier(8)->Range(1 << 12, 1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_fft_exact_convolution_wide)
+    ->RangeMultiplier(8)
+    ->Range(1 << 12, 1 << 18)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_poly_exp)->RangeMultiplier(8)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_poly_evaluate)->RangeMultiplier(8)->Range(1 << 10, 1 << 16)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_recurrence_nth)->RangeMultiplier(8)->Range(8, 1 << 12)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
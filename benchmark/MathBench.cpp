@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include <math/Basic.hpp>
+#include <math/ModArith.hpp>
+
+// odd 20-bit, odd 32-bit, odd 60-bit, even 60-bit
+static constexpr uint64_t cMods[] = {1'000'003, 4'294'967'291, 1'000'000'000'000'000'003, 1'000'000'000'000'000'002};
+
+// the pre-ModArith64 loop, widened to 128 bits so it stays correct above 2^32
+static uint64_t pow_mod_percent(uint64_t base, uint64_t k, uint64_t mod)
+{
+  using u128      = unsigned __int128;
+  uint64_t result = 1, b = base % mod;
+  for (; k > 0; k /= 2, b = u128{b} * b % mod)
+    if (k % 2 == 1) result = u128{result} * b % mod;
+  return result;
+}
+
+static void BM_pow_mod_percent(benchmark::State& state)
+{
+  uint64_t mod = cMods[state.range(0)], a = 2;
+  for (auto _ : state) benchmark::DoNotOptimize(a = pow_mod_percent(a + 1, mod - 1, mod));
+}
+
+static void BM_math_pow(benchmark::State& state)
+{
+  uint64_t mod = cMods[state.range(0)], a = 2;
+  for (auto _ : state) benchmark::DoNotOptimize(a = math::pow(a + 1, mod - 1, mod));
+}
+
+// one modulus, many powers: construction is paid once
+static void BM_ModArith64_reused(benchmark::State& state)
+{
+  uint64_t mod = cMods[state.range(0)], a = 2;
+  math::ModArith64 arith(mod);
+  for (auto _ : state) benchmark::DoNotOptimize(a = arith.pow_mod(a + 1, mod - 1));
+}
+
+BENCHMARK(BM_pow_mod_percent)->DenseRange(0, 3);
+BENCHMARK(BM_math_pow)->DenseRange(0, 3);
+BENCHMARK(BM_ModArith64_reused)->DenseRange(0, 3);
+
+BENCHMARK_MAIN();
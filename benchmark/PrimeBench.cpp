@@ -1,6 +1,32 @@
+#include <atomic>
 #include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <new>
+#include <utils/MultiplicativeOrder.hpp>
 #include <utils/Prime.hpp>
 
+// every plain operator new in this binary is counted, so the factor benchmarks can report allocations
+static std::atomic<uint64_t> gAllocations{0};
+
+void* operator new(size_t bytes)
+{
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(bytes == 0 ? 1 : bytes)) return ptr;
+  throw std::bad_alloc();
+}
+// out of line: inlined next to an inlined new, gcc takes the free for a mismatched deallocation
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+// runs the timed loop body and reports the allocations it made per iteration
+template <typename F> static void count_allocations(benchmark::State& state, F&& body)
+{
+  const uint64_t before = gAllocations.load(std::memory_order_relaxed);
+  for (auto _ : state) body();
+  const auto made          = gAllocations.load(std::memory_order_relaxed) - before;
+  state.counters["allocs"] = benchmark::Counter(static_cast<double>(made), benchmark::Counter::kAvgIterations);
+}
+
 PrimeSieve<5000> p;
 
 static void BM_PrimeSieve_ctor(benchmark::State& state)
@@ -13,12 +39,56 @@ static void BM_PrimeSieve_ctor_large(benchmark::State& state)
   for (auto _ : state) benchmark::DoNotOptimize(PrimeSieve<10000000>{});
 }
 
+static void BM_CompactPrimeSieve_ctor_large(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(CompactPrimeSieve<10000000>{});
+}
+
+static void BM_PrimeSieve_ctor_large_parallel(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(PrimeSieve<10000000>{prime::ParallelBuild{}});
+}
+
+static void BM_CompactPrimeSieve_ctor_large_parallel(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(CompactPrimeSieve<10000000>{prime::ParallelBuild{}});
+}
+
+static void BM_PrimeRange(benchmark::State& state)
+{
+  uint64_t lo = state.range(0);
+  for (auto _ : state)
+    for (uint64_t q : PrimeRange(lo, lo + 10'000'000)) benchmark::DoNotOptimize(q);
+}
+
 static void BM_is_prime_until(benchmark::State& state)
 {
   for (auto _ : state)
     for (int i = 2; i <= state.range(0); ++i) benchmark::DoNotOptimize(p.is_prime(i));
 }
 
+// beyond the table: exercised by Miller-Rabin / Pollard-Brent rather than trial division
+static constexpr uint64_t cLargeArgs[] = {
+    1000000007ULL,                // prime
+    999999000001ULL,              // prime
+    (1ULL << 61) - 1,             // prime
+    18446744073709551557ULL,      // largest 64-bit prime
+    1000003ULL * 999999000001ULL, // semiprime
+    4294967291ULL * 4294967279ULL // balanced semiprime
+};
+
+static void BM_is_prime_large(benchmark::State& state)
+{
+  uint64_t n = cLargeArgs[state.range(0)];
+  for (auto _ : state) benchmark::DoNotOptimize(p.is_prime(n));
+}
+
+static void BM_factors_large(benchmark::State& state)
+{
+  uint64_t n = cLargeArgs[state.range(0)];
+  for (auto _ : state) benchmark::DoNotOptimize(p.factors(n));
+}
+
 static void BM_factors(benchmark::State& state)
 {
   for (auto _ : state) benchmark::DoNotOptimize(p.factors(state.range(0)));
@@ -26,12 +96,198 @@ static void BM_factors(benchmark::State& state)
 
 static void BM_factors_freq(benchmark::State& state)
 {
-  for (auto _ : state) benchmark::DoNotOptimize(p.factors_freq(state.range(0)));
+  count_allocations(state, [&] { benchmark::DoNotOptimize(p.factors_freq(state.range(0))); });
 }
 
 static void BM_vector_factors_freq(benchmark::State& state)
 {
-  for (auto _ : state) benchmark::DoNotOptimize(p.vector_factors_freq(state.range(0)));
+  count_allocations(state, [&] { benchmark::DoNotOptimize(p.vector_factors_freq(state.range(0))); });
+}
+
+static void BM_small_factors_freq(benchmark::State& state)
+{
+  count_allocations(state, [&] { benchmark::DoNotOptimize(p.small_factors_freq(state.range(0))); });
+}
+
+static void BM_factors_freq_range(benchmark::State& state)
+{
+  count_allocations(state, [&]
+  {
+    for (int64_t i = 1; i <= state.range(0); ++i) benchmark::DoNotOptimize(p.factors_freq(i));
+  });
+}
+
+static void BM_small_factors_freq_range(benchmark::State& state)
+{
+  count_allocations(state, [&]
+  {
+    for (int64_t i = 1; i <= state.range(0); ++i) benchmark::DoNotOptimize(p.small_factors_freq(i));
+  });
+}
+
+static void BM_emit_factors_range(benchmark::State& state)
+{
+  count_allocations(state, [&]
+  {
+    for (int64_t i = 1; i <= state.range(0); ++i)
+    {
+      uint64_t last = 0;
+      p.emit_factors(i, [&](uint64_t q) { last = q; });
+      benchmark::DoNotOptimize(last);
+    }
+  });
+}
+
+static constexpr StaticPrimeSieve<100'000> cStatic{};
+
+// what a PrimeInt-style helper pays before its first answer
+static void BM_PrimeSieve_first_factor(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(PrimeSieve<100'000>{}.vector_factors_freq(83160));
+}
+
+static void BM_StaticPrimeSieve_first_factor(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(cStatic.vector_factors_freq(83160));
+}
+
+static void BM_StaticPrimeSieve_emit_factors_range(benchmark::State& state)
+{
+  for (auto _ : state)
+    for (int64_t i = 1; i <= state.range(0); ++i)
+    {
+      uint64_t last = 0;
+      cStatic.emit_factors(i, [&](uint64_t q) { last = q; });
+      benchmark::DoNotOptimize(last);
+    }
+}
+
+static void BM_DynamicPrimeSieve_grow_large(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(DynamicPrimeSieve{}.is_prime(10'000'000 - 1));
+}
+
+static void BM_DynamicPrimeSieve_emit_factors_range(benchmark::State& state)
+{
+  static const DynamicPrimeSieve sieve(1 << 21);
+  for (auto _ : state)
+    for (int64_t i = 1; i <= state.range(0); ++i)
+    {
+      uint64_t last = 0;
+      sieve.emit_factors(i, [&](uint64_t q) { last = q; });
+      benchmark::DoNotOptimize(last);
+    }
+}
+
+static void BM_SmoothNumbers(benchmark::State& state)
+{
+  const SmoothNumbers smooth(state.range(0), 83);
+  for (auto _ : state)
+  {
+    uint64_t count = 0;
+    smooth.for_each([&](uint64_t) { ++count; });
+    benchmark::DoNotOptimize(count);
+  }
+}
+
+// what enumerating by a highest-prime-factor table costs
+static void BM_smooth_by_factoring(benchmark::State& state)
+{
+  const CompactPrimeSieve<1 << 24> sieve;
+  for (auto _ : state)
+  {
+    uint64_t count = 0;
+    for (uint64_t i = 1; i <= (1 << 24); ++i) count += sieve.highest_prime_factor(i) <= 83;
+    benchmark::DoNotOptimize(count);
+  }
+}
+
+static void BM_PrimeBitmap_ctor_large(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(PrimeBitmap(10'000'000));
+}
+
+static void BM_PrimeBitmap_is_prime_until(benchmark::State& state)
+{
+  PrimeBitmap bm(state.range(0) + 1);
+  for (auto _ : state)
+    for (int64_t i = 1; i <= state.range(0); ++i) benchmark::DoNotOptimize(bm.is_prime(i));
+}
+
+static void BM_PrimeBitmap_next_prime_walk(benchmark::State& state)
+{
+  PrimeBitmap bm(state.range(0) + 1000);
+  for (auto _ : state)
+    for (uint64_t q = 2; q <= uint64_t(state.range(0)); q = bm.next_prime(q)) benchmark::DoNotOptimize(q);
+}
+
+static void BM_PrimeSums(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(PrimeSums<0>(state.range(0), state.range(1) ? state.range(1) : std::thread::hardware_concurrency())(state.range(0)));
+}
+
+static void BM_MultiplicativeTable_phi(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(MultiplicativeTable<10'000'000, prime::arith::cPhi>{});
+}
+
+static void BM_MultiplicativeTable_phi_parallel(benchmark::State& state)
+{
+  for (auto _ : state)
+    benchmark::DoNotOptimize(MultiplicativeTable<10'000'000, prime::arith::cPhi>{prime::ParallelBuild{}});
+}
+
+static void BM_phi_by_factoring(benchmark::State& state)
+{
+  CompactPrimeSieve<10'000'000> sieve;
+  std::vector<uint32_t> phi(10'000'001);
+  for (auto _ : state)
+  {
+    for (uint64_t n = 1; n <= 10'000'000; ++n)
+    {
+      uint64_t r = n;
+      sieve.for_each_prime_power(n, [&](uint64_t p, uint64_t) { r = r / p * (p - 1); });
+      phi[n] = r;
+    }
+    benchmark::DoNotOptimize(phi.data());
+  }
+}
+
+static void BM_MultiplicativeOrder(benchmark::State& state)
+{
+  for (auto _ : state) benchmark::DoNotOptimize(MultiplicativeOrder<1'000'000>(2, prime::ParallelBuild{1}));
+}
+
+// one lambda(n) trim per odd n, the approach the engine replaces
+static void BM_order_by_factoring(benchmark::State& state)
+{
+  PrimeSieve<1'000'000> sieve;
+  MultiplicativeTable<1'000'000, prime::arith::cCarmichael> lambda;
+  for (auto _ : state)
+    for (uint64_t n = 3; n <= 1'000'000; n += 2)
+    {
+      math::ModArith64 arith(n);
+      uint64_t t = lambda.carmichael(n);
+      sieve.for_each_prime_power(t, [&](uint64_t q, uint64_t e)
+      {
+        for (uint64_t i = 0; i < e && arith.pow_mod(2, t / q) == 1; ++i) t /= q;
+      });
+      benchmark::DoNotOptimize(t);
+    }
+}
+
+static void BM_vector_factors_freq_window(benchmark::State& state)
+{
+  uint64_t lo = state.range(0);
+  for (auto _ : state)
+    for (uint64_t n = lo; n < lo + (1 << 16); ++n) benchmark::DoNotOptimize(p.vector_factors_freq(n));
+}
+
+static void BM_FactorWindow(benchmark::State& state)
+{
+  uint64_t lo = state.range(0);
+  auto base   = FactorWindow::base_primes(lo + (1 << 16));
+  for (auto _ : state) benchmark::DoNotOptimize(FactorWindow(lo, lo + (1 << 16), base));
 }
 
 static void BM_distinct_factors_range(benchmark::State& state)
@@ -42,6 +298,10 @@ static void BM_distinct_factors_range(benchmark::State& state)
 
 BENCHMARK(BM_PrimeSieve_ctor);
 BENCHMARK(BM_PrimeSieve_ctor_large);
+BENCHMARK(BM_CompactPrimeSieve_ctor_large);
+BENCHMARK(BM_PrimeSieve_ctor_large_parallel)->UseRealTime();
+BENCHMARK(BM_CompactPrimeSieve_ctor_large_parallel)->UseRealTime();
+BENCHMARK(BM_PrimeRange)->Arg(0)->Arg(1'000'000'000'000)->Name("PrimeRange - 1e7 window");
 
 BENCHMARK(BM_is_prime_until)->Range(1 << 8, 1 << 12)->Arg(1 << 18);
 
@@ -61,6 +321,36 @@ BENCHMARK(BM_vector_factors_freq)
     ->Args({2347, 4567, 7919, 99991, 104729, 918234121, (1llu << 20) * 7919 * 7919})
     ->Name("vector_factors_freq - Primes");
 
+BENCHMARK(BM_is_prime_large)->DenseRange(0, 5)->Name("is_prime - beyond N");
+BENCHMARK(BM_factors_large)->DenseRange(0, 5)->Name("factors - beyond N");
+
+BENCHMARK(BM_vector_factors_freq_window)->Arg(100'000'000'000)->Name("vector_factors_freq - 2^16 window");
+BENCHMARK(BM_FactorWindow)->Arg(100'000'000'000)->Name("FactorWindow - 2^16 window");
+
 BENCHMARK(BM_distinct_factors_range)->Range(1 << 10, 1 << 20)->Name("distinct_factors 1..N");
+BENCHMARK(BM_PrimeBitmap_ctor_large);
+BENCHMARK(BM_PrimeBitmap_is_prime_until)->Range(1 << 8, 1 << 12)->Arg(1 << 18);
+BENCHMARK(BM_PrimeBitmap_next_prime_walk)->Arg(1 << 20)->Name("PrimeBitmap next_prime walk");
+BENCHMARK(BM_PrimeSums)
+    ->ArgsProduct({{10'000'000'000, 1'000'000'000'000}, {1, 0}})
+    ->ArgNames({"x", "threads"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MultiplicativeTable_phi)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MultiplicativeTable_phi_parallel)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_phi_by_factoring)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MultiplicativeOrder)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_order_by_factoring)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_small_factors_freq)->Args({60, 360, 5040, 83160, 1 << 16})->Name("small_factors_freq - Composite numbers");
+BENCHMARK(BM_factors_freq_range)->Arg(1 << 20)->Name("factors_freq 1..N");
+BENCHMARK(BM_small_factors_freq_range)->Arg(1 << 20)->Name("small_factors_freq 1..N");
+BENCHMARK(BM_emit_factors_range)->Arg(1 << 20)->Name("emit_factors 1..N");
+BENCHMARK(BM_PrimeSieve_first_factor);
+BENCHMARK(BM_StaticPrimeSieve_first_factor);
+BENCHMARK(BM_DynamicPrimeSieve_grow_large)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DynamicPrimeSieve_emit_factors_range)->Arg(1 << 20)->Name("DynamicPrimeSieve emit_factors 1..N");
+BENCHMARK(BM_SmoothNumbers)->Arg(1 << 24)->Arg(140'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_smooth_by_factoring)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StaticPrimeSieve_emit_factors_range)->Arg(100'000)->Name("StaticPrimeSieve emit_factors 1..N");
 
 BENCHMARK_MAIN();
@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <utils/Sumset.hpp>
+
+// dense random sets, about what A062241's active set looks like at its larger N
+static SumsetEngine random_engine(size_t n)
+{
+  std::mt19937 rng(1);
+  SumsetEngine e(n);
+  for (size_t a = 0; a < n; ++a)
+    if (rng() % 4 == 0) e.set(a);
+  return e;
+}
+
+// the byte loop A062241's has_sum ran before, worst case: no pair hits
+static void BM_has_sum_bytes(benchmark::State& state)
+{
+  const size_t n = state.range(0);
+  std::vector<char> active(n, 0);
+  for (size_t a = 0; a < n; a += 2) active[a] = 1;
+  const size_t target = n - 1;
+  for (auto _ : state)
+  {
+    bool found = false;
+    for (size_t j = 0; j <= target / 2 && !found; j++) found = active[j] && active[target - j];
+    benchmark::DoNotOptimize(found);
+  }
+}
+
+static void BM_has_sum_words(benchmark::State& state)
+{
+  const size_t n = state.range(0);
+  const auto simd = static_cast<fft::Simd>(state.range(1));
+  if (simd > fft::best_simd())
+  {
+    state.SkipWithError("kernel width not supported here");
+    return;
+  }
+  SumsetEngine e(n);
+  for (size_t a = 0; a < n; a += 2) e.set(a);
+  state.SetLabel(std::string(fft::to_string(simd)));
+  for (auto _ : state) benchmark::DoNotOptimize(e.has_sum(n - 1, simd));
+}
+
+static void BM_sum_counts(benchmark::State& state)
+{
+  const auto e = random_engine(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(e.sum_counts());
+}
+
+BENCHMARK(BM_has_sum_bytes)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_has_sum_words)->ArgsProduct({{1 << 12, 1 << 16, 1 << 20, 1 << 24}, {0, 1, 2}});
+BENCHMARK(BM_sum_counts)->RangeMultiplier(4)->Range(1 << 10, 1 << 16);
+
+BENCHMARK_MAIN();
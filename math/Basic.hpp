@@ -1,8 +1,11 @@
 #pragma once
 
 #include <algorithm>
+#include <concepts>
 #include <cstdint>
+#include <math/Montgomery.hpp>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace math {
@@ -19,8 +22,40 @@ template <typename T> [[nodiscard]] constexpr T pow(T base, uint64_t k)
   return result;
 }
 
-template <typename T> [[nodiscard]] constexpr T pow(T base, uint64_t k, T mod)
+namespace detail {
+
+// square and multiply with products formed in Wide
+template <typename Wide> [[nodiscard]] constexpr uint64_t pow_mod_in(uint64_t b, uint64_t k, uint64_t m)
+{
+  uint64_t result = 1 % m;
+  for (b %= m; k > 0; k /= 2, b = static_cast<uint64_t>(Wide{b} * b % m))
+    if (k % 2 == 1) result = static_cast<uint64_t>(Wide{result} * b % m);
+  return result;
+}
+
+// builtin integers never overflow: they run through Montgomery64 when the modulus is odd, or
+// 128-bit products at compile time and above 2^32
+template <typename T> [[nodiscard]] constexpr T pow_mod(T base, uint64_t k, T mod)
 {
+  if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t))
+  {
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) negative = base < 0 || mod <= 0;
+    if (!negative)
+    {
+      if (std::is_constant_evaluated())
+        return static_cast<T>(detail::pow_mod_in<unsigned __int128>(base, k, mod));
+      // Montgomery beats a divide per step for any odd modulus, even ones keep 64-bit % while products fit
+      if (mod % 2 == 1)
+      {
+        const Montgomery64 mont(mod);
+        return static_cast<T>(mont.from(mont.pow(mont.to(base), k)));
+      }
+      if (uint64_t(mod) <= UINT32_MAX) return static_cast<T>(detail::pow_mod_in<uint64_t>(base, k, mod));
+      return static_cast<T>(detail::pow_mod_in<unsigned __int128>(base, k, mod));
+    }
+  }
+
   T result = 1;
   T b      = base % mod;
   while (k > 0)
@@ -32,6 +67,38 @@ template <typename T> [[nodiscard]] constexpr T pow(T base, uint64_t k, T mod)
   return result;
 }
 
+// builtin base and mod work in their common type; anything else (BigInt, ...) in the base's type
+template <typename B, typename M> struct PowType
+{
+  using type = B;
+};
+template <std::integral B, std::integral M> struct PowType<B, M>
+{
+  using type = std::common_type_t<B, M>;
+};
+
+} // namespace detail
+
+// base and mod are deduced separately, so pow(2ull, k, uint64_t{m}) works whether uint64_t is unsigned
+// long or unsigned long long, and a mod wider than the base is never narrowed to it. A negative signed
+// base against an unsigned mod is reduced as the negative number it is, not as its wrapped image
+template <typename B, typename M, typename T = typename detail::PowType<B, M>::type>
+[[nodiscard]] constexpr T pow(B base, uint64_t k, M mod)
+{
+  if constexpr (std::is_integral_v<B> && std::is_integral_v<M> && std::is_unsigned_v<T>)
+  {
+    if constexpr (std::is_signed_v<M>)
+      if (mod <= 0) throw std::invalid_argument("math::pow: non-positive mod");
+    if constexpr (std::is_signed_v<B>)
+      if (base < 0)
+      {
+        const T m = static_cast<T>(mod), r = static_cast<T>(-(base + 1)) % m; // -(base + 1) can't overflow
+        return detail::pow_mod<T>(m - 1 - r, k, m);
+      }
+  }
+  return detail::pow_mod<T>(static_cast<T>(base), k, static_cast<T>(mod));
+}
+
 template <typename T> [[nodiscard]] constexpr T gcd(T a, T b)
 {
   if (a == 0 && b == 0) throw std::invalid_argument("gcd of zeros");
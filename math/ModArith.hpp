@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <math/Montgomery.hpp>
+#include <optional>
+#include <stdexcept>
+
+namespace math {
+
+/* ModArith64
+ * - arithmetic mod any n in [1, 2^64) in an internal form: to() on the way in, from() on the way out
+ * - odd n goes through Montgomery64; even n keeps plain residues, reduced with 64-bit % when the product fits
+ * - mul(plain, form) gives the plain product, handy for factors that are never converted
+ * - pow_mod(base, k) when a single power is all that is needed
+ * */
+class ModArith64
+{
+public:
+  using u128 = unsigned __int128;
+
+  explicit ModArith64(uint64_t n) : mN(n)
+  {
+    if (n == 0) throw std::invalid_argument("ModArith64: modulus must be positive");
+    if (n % 2 == 1) mMont.emplace(n);
+  }
+
+  [[nodiscard]] uint64_t modulus() const { return mN; }
+  [[nodiscard]] bool montgomery() const { return mMont.has_value(); }
+
+  [[nodiscard]] uint64_t to(uint64_t x) const { return mMont ? mMont->to(x) : x % mN; }
+  [[nodiscard]] uint64_t from(uint64_t x) const { return mMont ? mMont->from(x) : x; }
+  [[nodiscard]] uint64_t one() const { return to(1); }
+
+  [[nodiscard]] uint64_t mul(uint64_t a, uint64_t b) const
+  {
+    if (mMont) return mMont->mul(a, b);
+    if (((a | b) >> 32) == 0) return a * b % mN;
+    return static_cast<uint64_t>(static_cast<u128>(a) * b % mN);
+  }
+  [[nodiscard]] uint64_t add(uint64_t a, uint64_t b) const
+  {
+    uint64_t s = a + b;
+    return (s >= mN || s < a) ? s - mN : s;
+  }
+  [[nodiscard]] uint64_t sub(uint64_t a, uint64_t b) const { return a >= b ? a - b : a - b + mN; }
+
+  // a in internal form
+  [[nodiscard]] uint64_t pow(uint64_t a, uint64_t k) const
+  {
+    if (mMont) return mMont->pow(a, k);
+    uint64_t result = one();
+    for (; k > 0; k >>= 1, a = mul(a, a))
+      if (k & 1) result = mul(result, a);
+    return result;
+  }
+
+  // base^k mod n on plain values
+  [[nodiscard]] uint64_t pow_mod(uint64_t base, uint64_t k) const { return from(pow(to(base), k)); }
+
+private:
+  uint64_t mN;
+  std::optional<Montgomery64> mMont; // only for odd n
+};
+
+} // namespace math
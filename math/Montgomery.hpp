@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+namespace math {
+
+// arithmetic mod an odd n < 2^64 in Montgomery form (x -> x * 2^64 mod n), no divide after construction
+class Montgomery64
+{
+public:
+  using u128 = unsigned __int128;
+
+  constexpr explicit Montgomery64(uint64_t n) : mN(n), mR2(static_cast<uint64_t>(-static_cast<u128>(n) % n))
+  {
+    mNInv = n; // n * n == 1 mod 8, every Newton step doubles the correct bits
+    for (int i = 0; i < 5; ++i) mNInv *= 2 - n * mNInv;
+  }
+
+  [[nodiscard]] constexpr uint64_t modulus() const { return mN; }
+  [[nodiscard]] constexpr uint64_t to(uint64_t x) const { return reduce(static_cast<u128>(x % mN) * mR2); }
+  [[nodiscard]] constexpr uint64_t from(uint64_t x) const { return reduce(x); }
+  [[nodiscard]] constexpr uint64_t mul(uint64_t a, uint64_t b) const
+  {
+    return reduce(static_cast<u128>(a) * b);
+  }
+  [[nodiscard]] constexpr uint64_t add(uint64_t a, uint64_t b) const
+  {
+    uint64_t s = a + b;
+    return (s >= mN || s < a) ? s - mN : s;
+  }
+  [[nodiscard]] constexpr uint64_t sub(uint64_t a, uint64_t b) const { return a >= b ? a - b : a - b + mN; }
+  [[nodiscard]] constexpr uint64_t pow(uint64_t a, uint64_t k) const
+  {
+    uint64_t result = to(1);
+    for (; k > 0; k >>= 1, a = mul(a, a))
+      if (k & 1) result = mul(result, a);
+    return result;
+  }
+
+private:
+  [[nodiscard]] constexpr uint64_t reduce(u128 t) const
+  {
+    uint64_t m  = static_cast<uint64_t>(t) * mNInv;
+    uint64_t hi = static_cast<uint64_t>(t >> 64);
+    uint64_t mn = static_cast<uint64_t>((static_cast<u128>(m) * mN) >> 64);
+    return hi >= mn ? hi - mn : hi - mn + mN;
+  }
+
+  uint64_t mN;
+  uint64_t mR2;   // 2^128 mod n
+  uint64_t mNInv; // n^-1 mod 2^64
+};
+
+} // namespace math
@@ -0,0 +1,52 @@
+#include <atomic>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <utils/Parallel.hpp>
+#include <utils/Prime.hpp>
+
+TEST(DynamicPrimeSieveTest, GrowsOnDemand)
+{
+  constexpr uint64_t n = 2'000'000;
+  CompactPrimeSieve<n> sieve;
+  DynamicPrimeSieve grown;
+  EXPECT_EQ(grown.limit(), DynamicPrimeSieve::cFirstBlock);
+
+  // a far query first, then everything below it from the blocks already there
+  EXPECT_EQ(grown.factors(n - 1), sieve.factors(n - 1));
+  EXPECT_GE(grown.limit(), n);
+  for (uint64_t i = 1; i <= n; ++i)
+  {
+    ASSERT_EQ(grown.is_prime(i), sieve.is_prime(i)) << i;
+    ASSERT_EQ(grown.lowest_prime_factor(i), sieve.lowest_prime_factor(i)) << i;
+  }
+
+  DynamicPrimeSieve capped(0, 1 << 20);
+  for (uint64_t i : {1'000'003ull, 1'000'000'007ull, 11ull * 9901 * 99991, 4294967291ull * 4294967279ull})
+  {
+    EXPECT_EQ(capped.is_prime(i), sieve.is_prime(i)) << i;
+    EXPECT_EQ(capped.factors(i), sieve.factors(i)) << i;
+  }
+  EXPECT_LE(capped.limit(), capped.max_limit());
+  EXPECT_THROW((void)capped.lowest_prime_factor(1 << 20), std::out_of_range);
+  EXPECT_THROW(DynamicPrimeSieve(0, uint64_t{1} << 33), std::invalid_argument);
+  EXPECT_THROW(DynamicPrimeSieve(0, 0), std::invalid_argument); // before sieving base primes to 2^32
+}
+
+TEST(DynamicPrimeSieveTest, ConcurrentQueries)
+{
+  constexpr uint64_t n = 4'000'000;
+  CompactPrimeSieve<n> sieve;
+  DynamicPrimeSieve shared;
+
+  // every worker walks upwards, so reads race with growth triggered by the others
+  std::vector<uint64_t> workers(8);
+  std::iota(workers.begin(), workers.end(), 0);
+  std::atomic<uint64_t> mismatches = 0;
+  utils::parallel::foreach(workers, [&](uint64_t w)
+  {
+    for (uint64_t i = 2 + w; i <= n; i += 7 * workers.size())
+      if (shared.lowest_prime_factor(i) != sieve.lowest_prime_factor(i)) ++mismatches;
+  }, workers.size());
+  EXPECT_EQ(mismatches, 0);
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <utils/Prime.hpp>
+
+TEST(FactorWindowTest, MatchesSieve)
+{
+  PrimeSieve<2000> pf;
+
+  const auto doTest = [&](const FactorWindow& w)
+  {
+    for (uint64_t n = w.lo(); n < w.hi(); ++n)
+    {
+      auto expected = pf.vector_factors_freq(n);
+      auto got      = w.factors(n);
+      ASSERT_EQ(std::vector(got.begin(), got.end()), expected) << n;
+      ASSERT_EQ(w.highest_prime_factor(n), n == 1 ? 1 : expected.back().first) << n;
+    }
+  };
+
+  doTest(FactorWindow(1, 5000));
+  doTest(FactorWindow(1'000'000'000'000ULL, 1'000'000'005'000ULL));
+  PrimeSieve<1'000'000> base;
+  doTest(FactorWindow(999'999'000'000ULL, 999'999'003'000ULL, base.all_primes()));
+  doTest(FactorWindow(1024, 1025));
+}
+
+TEST(FactorWindowTest, RejectsBadInput)
+{
+  PrimeSieve<10> pf;
+  EXPECT_THROW(FactorWindow(0, 10), std::invalid_argument);
+  EXPECT_THROW(FactorWindow(1000, 2000, pf.all_primes()), std::invalid_argument);
+  EXPECT_NO_THROW(FactorWindow(100, 121, pf.all_primes())); // 7 is the last prime up to sqrt(120)
+  EXPECT_THROW(FactorWindow(100, 122, pf.all_primes()), std::invalid_argument); // 121 needs 11
+}
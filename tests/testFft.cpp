@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <random>
+#include <thread>
 #include <utils/Fft.hpp>
 
 using namespace fft;
@@ -80,3 +82,168 @@ TEST(FftTest, ConvolutionLarge)
     EXPECT_NEAR(c[i].imag(), expected[i].imag(), eps);
   }
 }
+
+TEST(FftTest, PlanIsCachedPerSize)
+{
+  auto p = plan(1024);
+  EXPECT_EQ(p, plan(1024));
+  EXPECT_NE(p, plan(2048));
+  EXPECT_EQ(p->size(), 1024);
+  EXPECT_THROW((void)plan(1000), std::invalid_argument);
+
+  clear_plans();
+  EXPECT_NE(p, plan(1024)); // a fresh one, the old plan lives on in p
+  EXPECT_EQ(p->size(), 1024);
+}
+
+TEST(FftTest, PlanSharedAcrossThreads)
+{
+  std::vector<cd> original(4096);
+  for (size_t i = 0; i < original.size(); ++i) original[i] = cd(i % 13, i % 7);
+
+  clear_plans();
+  std::vector<std::thread> pool;
+  std::vector<std::vector<cd>> results(8, original);
+  for (auto& r : results)
+    pool.emplace_back([&r]
+    {
+      transform<Direction::Forward>(r);
+      transform<Direction::Inverse>(r);
+    });
+  for (auto& t : pool) t.join();
+
+  for (const auto& r : results)
+    for (size_t i = 0; i < original.size(); ++i)
+    {
+      ASSERT_NEAR(original[i].real(), r[i].real(), DOUBLE_COMPARE_EPS);
+      ASSERT_NEAR(original[i].imag(), r[i].imag(), DOUBLE_COMPARE_EPS);
+    }
+}
+
+TEST(FftTest, RealConvolutionMatchesNaive)
+{
+  std::mt19937 rng(5);
+  for (auto [n, m] : {std::pair{1, 1}, {1, 2}, {2, 2}, {3, 5}, {100, 37}, {1000, 1000}})
+  {
+    std::vector<int> a(n), b(m);
+    for (int& x : a) x = rng() % 1000;
+    for (int& x : b) x = rng() % 1000;
+
+    std::vector<int64_t> expected(n + m - 1, 0);
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < m; ++j) expected[i + j] += int64_t{a[i]} * b[j];
+
+    EXPECT_EQ(round<int64_t>(convolution(a, b)), expected) << n << ' ' << m;
+    EXPECT_EQ(round<int64_t>(convolution(b, a)), expected) << n << ' ' << m;
+  }
+}
+
+TEST(FftTest, RealSelfConvolutionMatchesComplex)
+{
+  std::mt19937 rng(9);
+  for (size_t n : {1, 2, 3, 64, 4097})
+  {
+    std::vector<size_t> active(n);
+    for (auto& x : active) x = rng() % 2;
+    std::vector<cd> complexInput(active.begin(), active.end());
+
+    auto viaReal    = self_convolution(active);
+    auto viaComplex = self_convolution(complexInput);
+    ASSERT_EQ(viaReal.size(), viaComplex.size());
+    for (size_t i = 0; i < viaReal.size(); ++i)
+      EXPECT_NEAR(viaReal[i], viaComplex[i].real(), 1e-6) << n << ' ' << i;
+  }
+}
+
+TEST(FftTest, EverySimdWidthMatchesNaiveDft)
+{
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  // odd and even numbers of stages, and sizes below each vector width
+  for (size_t n : {1, 2, 4, 8, 16, 32, 64, 512, 2048})
+  {
+    std::vector<cd> original(n);
+    for (auto& x : original) x = cd(dist(rng), dist(rng));
+
+    std::vector<cd> naive(n);
+    for (size_t k = 0; k < n; ++k)
+      for (size_t j = 0; j < n; ++j)
+        naive[k] += original[j] * std::polar(1.0, 2 * std::numbers::pi * (j * k % n) / n);
+
+    const auto p = plan(n);
+    for (Simd simd : {Simd::Scalar, Simd::Avx2, Simd::Avx512})
+    {
+      if (simd > best_simd()) continue;
+      auto trans = original;
+      p->execute<Direction::Forward>(trans, simd);
+      for (size_t k = 0; k < n; ++k)
+        EXPECT_NEAR(std::abs(trans[k] - naive[k]), 0, 1e-9) << n << ' ' << to_string(simd);
+      p->execute<Direction::Inverse>(trans, simd);
+      for (size_t k = 0; k < n; ++k)
+        EXPECT_NEAR(std::abs(trans[k] - original[k]), 0, 1e-12) << n << ' ' << to_string(simd);
+    }
+  }
+}
+
+TEST(FftTest, FourStepMatchesDirect)
+{
+  std::mt19937 rng(13);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  // forcing four-step from size 4 covers square and non-square splits; 2^21 is the default cut
+  for (size_t n : {size_t{4}, size_t{8}, size_t{64}, size_t{1} << 11, size_t{1} << 12, FftPlan::cFourStepMin})
+  {
+    const FftPlan fourStep(n, 4), direct(n, SIZE_MAX);
+    ASSERT_TRUE(fourStep.four_step());
+    ASSERT_FALSE(direct.four_step());
+
+    std::vector<cd> original(n);
+    for (auto& x : original) x = cd(dist(rng), dist(rng));
+    auto viaFourStep = original, viaDirect = original;
+    fourStep.execute<Direction::Forward>(viaFourStep);
+    direct.execute<Direction::Forward>(viaDirect);
+    for (size_t k = 0; k < n; ++k)
+      ASSERT_NEAR(std::abs(viaFourStep[k] - viaDirect[k]), 0, 1e-9) << n << ' ' << k;
+
+    fourStep.execute<Direction::Inverse>(viaFourStep);
+    for (size_t k = 0; k < n; ++k)
+      ASSERT_NEAR(std::abs(viaFourStep[k] - original[k]), 0, 1e-12) << n << ' ' << k;
+  }
+  EXPECT_TRUE(plan(FftPlan::cFourStepMin)->four_step());
+  EXPECT_FALSE(plan(FftPlan::cFourStepMin / 2)->four_step());
+}
+
+TEST(FftTest, ErrorBoundFlagsUnsafeInputs)
+{
+  const std::vector<uint32_t> bits(1 << 16, 1), wide(1 << 16, UINT32_MAX);
+  EXPECT_LT(rounding_error_bound(bits, bits), 0.5);
+  EXPECT_GT(rounding_error_bound(wide, wide), 0.5);
+  // the bound is an upper bound: the plain path on 0/1 data agrees with the exact one
+  EXPECT_EQ(round<uint64_t>(self_convolution(bits)), exact_self_convolution(bits));
+}
+
+TEST(FftTest, ExactConvolutionMatchesNaive)
+{
+  std::mt19937_64 rng(17);
+  // naive sums wrap mod 2^64 just like the exact path promises to
+  const auto naive = [](const std::vector<uint64_t>& a, const std::vector<uint64_t>& b)
+  {
+    std::vector<uint64_t> c(a.size() + b.size() - 1, 0);
+    for (size_t i = 0; i < a.size(); ++i)
+      for (size_t j = 0; j < b.size(); ++j) c[i + j] += a[i] * b[j];
+    return c;
+  };
+
+  // single limb, 16-bit limbs, and full 64-bit values whose products wrap
+  for (int bits : {1, 20, 32, 48, 64})
+    for (auto [n, m] : {std::pair{1, 1}, {3, 2}, {100, 37}, {2000, 1500}})
+    {
+      std::vector<uint64_t> a(n), b(m);
+      for (auto& x : a) x = bits == 64 ? rng() : rng() % (uint64_t{1} << bits);
+      for (auto& x : b) x = bits == 64 ? rng() : rng() % (uint64_t{1} << bits);
+      EXPECT_EQ(exact_convolution(a, b), naive(a, b)) << bits << ' ' << n << ' ' << m;
+      EXPECT_EQ(exact_self_convolution(a), naive(a, a)) << bits << ' ' << n;
+    }
+
+  EXPECT_TRUE(exact_convolution(std::vector<int>{}, std::vector<int>{1}).empty());
+  EXPECT_THROW((void)exact_convolution(std::vector<int>{1, -1}, std::vector<int>{1}), std::invalid_argument);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <math/Basic.hpp>
+#include <math/ModArith.hpp>
 #include <math/Stats.hpp>
 #include <utils/BigInt.hpp>
 
@@ -31,6 +32,48 @@ TEST(BasicMath, PowModLarge)
   for (uint64_t a : {6, 1923, 5729, 9181}) EXPECT_EQ(pow<uint64_t>(a, 1e9 + 7, 1e9 + 7), a);
 }
 
+TEST(BasicMath, PowModAbove32Bits)
+{
+  // Fermat with 64-bit prime moduli, where squaring in uint64 would overflow
+  for (uint64_t p : {4294967311ULL, 1000000000000000003ULL, 18446744073709551557ULL})
+    for (uint64_t a : {uint64_t{2}, uint64_t{3}, uint64_t{123456789}, p - 1})
+    {
+      EXPECT_EQ(pow(a, p - 1, p), 1) << a << " " << p;
+      EXPECT_EQ(pow(a, p, p), a) << a << " " << p;
+    }
+  // even moduli take the non-Montgomery path
+  EXPECT_EQ(pow<uint64_t>(3, 4, uint64_t{1} << 40), 81);
+  EXPECT_EQ(pow<uint64_t>(3, uint64_t{1} << 38, uint64_t{1} << 40), 1);
+  static_assert(pow(2ULL, 64, 1000000000000000003ULL) == 446744073709551562ULL);
+
+  // a 64-bit mod is never narrowed to an int base, and a negative base stays negative
+  const uint64_t wide = 1000000000000000003ULL;
+  EXPECT_EQ(pow(2, 64, wide), 446744073709551562ULL);
+  EXPECT_EQ(pow(-2, 3, uint64_t{7}), 6u);
+  EXPECT_EQ(pow(int64_t{-1} << 62, 1, wide), wide - (uint64_t{1} << 62) % wide);
+  EXPECT_EQ(pow(uint32_t{3}, 2, 5ul), 4u);
+}
+
+TEST(ModArith, MatchesWideProducts)
+{
+  for (uint64_t n : {1ULL, 2ULL, 97ULL, 1ULL << 33, 999999999989ULL, 18446744073709551615ULL})
+  {
+    ModArith64 arith(n);
+    EXPECT_EQ(arith.montgomery(), n % 2 == 1) << n;
+    for (uint64_t a : {0ULL, 1ULL, 5ULL, 4294967296ULL, 18446744073709551614ULL})
+      for (uint64_t b : {0ULL, 3ULL, 4294967297ULL, 12345678901234567ULL})
+      {
+        using u128 = unsigned __int128;
+        const u128 ra = a % n, rb = b % n;
+        auto x = arith.to(a), y = arith.to(b);
+        EXPECT_EQ(arith.from(arith.mul(x, y)), uint64_t(ra * rb % n)) << a << " " << b << " " << n;
+        EXPECT_EQ(arith.from(arith.add(x, y)), uint64_t((ra + rb) % n)) << a << " " << b << " " << n;
+        EXPECT_EQ(arith.from(arith.sub(x, y)), uint64_t((ra + n - rb) % n)) << a << " " << b << " " << n;
+      }
+  }
+  EXPECT_THROW(ModArith64(0), std::invalid_argument);
+}
+
 TEST(BasicMath, GCDBasic)
 {
   EXPECT_EQ(gcd(10, 5), 5);
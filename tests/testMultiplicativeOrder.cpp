@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <utils/MultiplicativeOrder.hpp>
+#include <utils/Prime.hpp>
+
+TEST(MultiplicativeOrderTest, MatchesBruteForce)
+{
+  const auto brute = [](uint64_t b, uint64_t n) -> uint64_t
+  {
+    if (n == 1) return 1;
+    if (std::gcd(b, n) != 1) return 0;
+    uint64_t x = b % n, k = 1;
+    for (; x != 1; ++k) x = x * b % n;
+    return k;
+  };
+
+  for (uint64_t b : {2, 3, 6, 10})
+  {
+    MultiplicativeOrder<5000> order(b);
+    for (uint64_t n = 1; n <= 5000; ++n) ASSERT_EQ(order(n), brute(b, n)) << b << " " << n;
+  }
+
+  // past the serial prefix, so the parallel rounds run too
+  MultiplicativeOrder<300'000> order(2, prime::ParallelBuild{4});
+  for (uint64_t n = 299'000; n <= 300'000; ++n) ASSERT_EQ(order(n), brute(2, n)) << n;
+
+  // a borrowed wide sieve and a runtime limit give the same orders
+  const PrimeSieve<300'000> sieve;
+  MultiplicativeOrder<300'000> borrowed(2, sieve, 200'001, prime::ParallelBuild{4});
+  EXPECT_EQ(borrowed.limit(), 200'001u);
+  for (uint64_t n = 1; n <= 200'001; ++n) ASSERT_EQ(borrowed(n), order(n)) << n;
+  EXPECT_THROW(MultiplicativeOrder<300'000>(2, sieve, 300'001), std::invalid_argument);
+  EXPECT_THROW(MultiplicativeOrder<300'000>(1, sieve), std::invalid_argument);
+}
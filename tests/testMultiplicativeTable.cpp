@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include <utils/Prime.hpp>
+
+TEST(MultiplicativeTableTest, MatchesFactorization)
+{
+  constexpr uint64_t n = 100'000;
+  PrimeSieve<n> pf;
+  MultiplicativeTable<n> serial;
+  MultiplicativeTable<n> parallel{prime::ParallelBuild{4}};
+
+  for (uint64_t i = 1; i <= n; ++i)
+  {
+    uint64_t phi = 1, sigma = 1, carmichael = 1;
+    int mobius = 1, liouville = 1;
+    auto freq  = pf.vector_factors_freq(i);
+    for (auto [p, e] : freq)
+    {
+      uint64_t pe = 1;
+      for (uint64_t k = 0; k < e; ++k) pe *= p;
+      phi *= pe / p * (p - 1);
+      sigma *= (pe * p - 1) / (p - 1);
+      carmichael = std::lcm(carmichael, p == 2 && e >= 3 ? pe / 4 : pe / p * (p - 1));
+      mobius     = e > 1 ? 0 : -mobius;
+      liouville *= e % 2 ? -1 : 1;
+    }
+
+    for (const auto* t : {&serial, &parallel})
+    {
+      ASSERT_EQ(t->phi(i), phi) << i;
+      ASSERT_EQ(t->mobius(i), mobius) << i;
+      ASSERT_EQ(t->sigma(i), sigma) << i;
+      ASSERT_EQ(t->omega(i), freq.size()) << i;
+      ASSERT_EQ(t->liouville(i), liouville) << i;
+      ASSERT_EQ(t->carmichael(i), carmichael) << i;
+    }
+  }
+}
+
+TEST(MultiplicativeTableTest, SelectedFunctionsOnly)
+{
+  MultiplicativeTable<1000, prime::arith::cPhi | prime::arith::cCarmichael> t;
+  EXPECT_EQ(t.phi(1), 1);
+  EXPECT_EQ(t.phi(997), 996);
+  EXPECT_EQ(t.carmichael(8), 2);
+  EXPECT_EQ(t.carmichael(1000), 100);
+}
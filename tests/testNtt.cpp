@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <utils/Fft.hpp>
+#include <utils/Ntt.hpp>
+
+using namespace ntt;
+
+constexpr uint32_t P0 = cPrimes[0], P1 = cPrimes[1], P2 = cPrimes[2];
+
+template <typename T> std::vector<uint64_t> naive(const std::vector<T>& a, const std::vector<T>& b)
+{
+  std::vector<uint64_t> c(a.size() + b.size() - 1, 0);
+  for (size_t i = 0; i < a.size(); ++i)
+    for (size_t j = 0; j < b.size(); ++j) c[i + j] += uint64_t(a[i]) * uint64_t(b[j]);
+  return c;
+}
+
+TEST(NttTest, TransformBack)
+{
+  std::mt19937 rng(7);
+  for (size_t n : {1, 2, 8, 1024})
+  {
+    std::vector<ModInt<P0, P1, P2>> original(n);
+    for (auto& x : original) x = ModInt<P0, P1, P2>(rng());
+
+    auto trans = original;
+    transform<fft::Direction::Forward>(trans);
+    transform<fft::Direction::Inverse>(trans);
+    EXPECT_EQ(trans, original) << n;
+  }
+
+  std::vector<ModInt<P0>> bad(12);
+  EXPECT_THROW(transform<fft::Direction::Forward>(bad), std::invalid_argument);
+  EXPECT_EQ(plan<P0>(64), plan<P0>(64));
+}
+
+TEST(NttTest, Reconstruct)
+{
+  for (uint64_t v : {uint64_t{0}, uint64_t{12345}, uint64_t{1} << 40, UINT64_MAX, (uint64_t{1} << 63) + 99})
+  {
+    ModInt<P0, P1, P2> x;
+    x.mVals = {uint32_t(v % P0), uint32_t(v % P1), uint32_t(v % P2)};
+    EXPECT_EQ(reconstruct(x), v);
+  }
+}
+
+TEST(NttTest, ConvolutionMatchesNaive)
+{
+  std::mt19937_64 rng(11);
+  // 0/1 needs one prime, 1e6 two, 2^40 all three
+  for (uint64_t top : {uint64_t{1}, uint64_t{1'000'000}, uint64_t{1} << 40})
+    for (auto [n, m] : {std::pair{1, 1}, {3, 2}, {100, 37}, {513, 511}})
+    {
+      std::vector<uint64_t> a(n), b(m);
+      for (auto& x : a) x = rng() % (top + 1);
+      for (auto& x : b) x = rng() % (top + 1);
+      EXPECT_EQ(convolution(a, b), naive(a, b)) << top << ' ' << n << ' ' << m;
+    }
+
+  EXPECT_TRUE(convolution(std::vector<int>{}, std::vector<int>{1}).empty());
+  EXPECT_THROW((void)convolution(std::vector<int>{1, -1}, std::vector<int>{1}), std::invalid_argument);
+}
+
+TEST(NttTest, SelfConvolutionMatchesFft)
+{
+  std::mt19937 rng(3);
+  std::vector<size_t> active(5000);
+  for (auto& x : active) x = rng() % 2;
+
+  EXPECT_EQ(self_convolution(active), naive(active, active));
+  auto viaFft = fft::round<size_t>(fft::self_convolution(active));
+  EXPECT_TRUE(std::ranges::equal(self_convolution(active), viaFft));
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <utils/Ntt.hpp>
+#include <utils/Poly.hpp>
+
+constexpr uint32_t P0 = ntt::cPrimes[0], P1 = ntt::cPrimes[1];
+using M = ModInt<998244353>;
+using P = Poly<M>;
+
+static P random_poly(std::mt19937& rng, size_t n)
+{
+  std::vector<M> c(n);
+  for (auto& x : c) x = M(rng());
+  return P(std::move(c));
+}
+
+static P naive_multiply(const P& a, const P& b)
+{
+  std::vector<M> c(a.size() + b.size() - 1);
+  for (size_t i = 0; i < a.size(); ++i)
+    for (size_t j = 0; j < b.size(); ++j) c[i + j] += a[i] * b[j];
+  return P(std::move(c));
+}
+
+TEST(PolyTest, MultiplyMatchesNaive)
+{
+  std::mt19937 rng(5);
+  for (auto [n, m] : {std::pair{1, 1}, {7, 40}, {33, 33}, {300, 129}, {1000, 1000}})
+  {
+    P a = random_poly(rng, n), b = random_poly(rng, m);
+    EXPECT_EQ(a * b, naive_multiply(a, b)) << n << ' ' << m;
+  }
+
+  // several primes at once, as ntt::convolution pairs them
+  using M2 = ModInt<P0, P1>;
+  Poly<M2> a{M2(3), M2(1)}, b(std::vector<M2>(100, M2(2)));
+  Poly<M2> c = a * b;
+  EXPECT_EQ(c.size(), 101u);
+  EXPECT_EQ(c[0], M2(6));
+  EXPECT_EQ(c[50], M2(8));
+  EXPECT_EQ(c[100], M2(2));
+}
+
+TEST(PolyTest, KnownSeries)
+{
+  const size_t n = 2000;
+
+  // 1 / (1 - x - x^2) is the Fibonacci numbers
+  P fib = P{M(1), -M(1), -M(1)}.inverse(n);
+  M f0 = 0, f1 = 1;
+  for (size_t i = 0; i < n; ++i)
+  {
+    EXPECT_EQ(fib[i], f1) << i;
+    f1 = f0 + f1;
+    f0 = f1 - f0;
+  }
+
+  // exp(x) = sum x^k / k!, log(1 / (1 - x)) = sum x^k / k, sqrt(1 - 4x) = 1 - 2 x C(x)
+  P e = P{M(0), M(1)}.exp(n), l = P(std::vector<M>(n, M(1))).log(n), s = P{M(1), -M(4)}.sqrt(n);
+  M fact = 1, catalan = 1;
+  EXPECT_EQ(l[0], M(0));
+  EXPECT_EQ(s[0], M(1));
+  for (size_t k = 1; k < n; ++k)
+  {
+    fact *= M(uint32_t(k));
+    EXPECT_EQ(e[k] * fact, M(1)) << k;
+    EXPECT_EQ(l[k] * M(uint32_t(k)), M(1)) << k;
+    EXPECT_EQ(s[k], -M(2) * catalan) << k;
+    catalan = catalan * M(uint32_t(2 * (2 * k - 1))) / M(uint32_t(k + 1));
+  }
+}
+
+TEST(PolyTest, NewtonOperationsRoundTrip)
+{
+  std::mt19937 rng(9);
+  for (size_t n : {1, 2, 17, 100, 1 << 12})
+  {
+    P f = random_poly(rng, n);
+    f[0] = M(1);
+    EXPECT_EQ((f * f.inverse(n)).truncated(n), P{M(1)}) << n;
+
+    P s = f.sqrt(n);
+    EXPECT_EQ((s * s).truncated(n), f) << n;
+    EXPECT_EQ(f.log(n).exp(n), f) << n;
+
+    f[0] = M(0);
+    EXPECT_EQ(f.exp(n).log(n), f) << n;
+  }
+
+  EXPECT_THROW((void)P({M(0), M(1)}).inverse(4), std::invalid_argument);
+  EXPECT_THROW((void)P({M(2), M(1)}).log(4), std::invalid_argument);
+  EXPECT_THROW((void)P({M(1), M(1)}).exp(4), std::invalid_argument);
+  EXPECT_THROW((void)P{M(3)}.sqrt(4), std::invalid_argument);
+}
+
+TEST(PolyTest, DivisionWithRemainder)
+{
+  std::mt19937 rng(13);
+  for (auto [n, m] : {std::pair{10, 3}, {5, 9}, {100, 90}, {1000, 200}, {3000, 1500}})
+  {
+    P a = random_poly(rng, n), b = random_poly(rng, m);
+    auto [q, r] = a.divmod(b);
+    EXPECT_LT(r.degree(), b.degree()) << n << ' ' << m;
+    EXPECT_EQ(b * q + r, a) << n << ' ' << m;
+  }
+
+  EXPECT_THROW((void)(P{M(1)} / P{M(0)}), std::invalid_argument);
+}
+
+TEST(PolyTest, MultipointEvaluationMatchesHorner)
+{
+  std::mt19937 rng(17);
+  for (auto [n, m] : {std::pair{1, 1}, {50, 10}, {500, 1000}, {3000, 2000}})
+  {
+    P f = random_poly(rng, n);
+    std::vector<M> points(m);
+    for (auto& x : points) x = M(rng());
+    points[0] = M(0);
+
+    const auto values = f.evaluate(points);
+    ASSERT_EQ(values.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) EXPECT_EQ(values[i], f(points[i])) << n << ' ' << i;
+  }
+  EXPECT_TRUE(P{M(1)}.evaluate({}).empty());
+}
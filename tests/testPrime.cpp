@@ -1,8 +1,14 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <ranges>
 #include <stdexcept>
 #include <utils/Prime.hpp>
 
-using prime = size_t;
+using prime_t = size_t;
 
 TEST(PrimeTest, SmallNumbers)
 {
@@ -17,7 +23,7 @@ TEST(PrimeTest, SmallNumbers)
   EXPECT_EQ(freq7[7], 1);
 
   auto factors12                = pf.factors(12);
-  std::vector<prime> expected12 = {2, 2, 3};
+  std::vector<prime_t> expected12 = {2, 2, 3};
   EXPECT_EQ(factors12, expected12);
 
   auto freq12 = pf.factors_freq(12);
@@ -26,7 +32,7 @@ TEST(PrimeTest, SmallNumbers)
   EXPECT_EQ(freq12[3], 1);
 
   auto factors18                = pf.factors(18);
-  std::vector<prime> expected18 = {2, 3, 3};
+  std::vector<prime_t> expected18 = {2, 3, 3};
   EXPECT_EQ(factors18, expected18);
 
   auto freq18 = pf.factors_freq(18);
@@ -44,13 +50,21 @@ TEST(PrimeTest, EdgeCases)
   EXPECT_EQ(factors2[0], 2);
 
   auto factors10                = pf.factors(10);
-  std::vector<prime> expected10 = {2, 5};
+  std::vector<prime_t> expected10 = {2, 5};
   EXPECT_EQ(factors10, expected10);
 
   auto freq10 = pf.factors_freq(10);
   ASSERT_EQ(freq10.size(), 2);
   EXPECT_EQ(freq10[2], 1);
   EXPECT_EQ(freq10[5], 1);
+
+  // zero has every prime as a factor: every sieve refuses it instead of dividing 0 by 2 forever
+  static constexpr StaticPrimeSieve<100> fixed;
+  DynamicPrimeSieve dynamic;
+  EXPECT_THROW((void)pf.factors(0), std::invalid_argument);
+  EXPECT_THROW((void)fixed.small_factors_freq(0), std::invalid_argument);
+  EXPECT_THROW((void)fixed.factors(0), std::invalid_argument);
+  EXPECT_THROW((void)dynamic.factors(0), std::invalid_argument);
 }
 
 TEST(PrimeTest, WorksForOutOfRange)
@@ -58,11 +72,11 @@ TEST(PrimeTest, WorksForOutOfRange)
   PrimeSieve<10> pf;
 
   ASSERT_TRUE(pf.factors(1).empty());
-  ASSERT_EQ(pf.factors(11), std::vector<prime>{11});
-  ASSERT_EQ(pf.factors(15), std::vector<prime>({3, 5}));
-  ASSERT_EQ(pf.factors(50), std::vector<prime>({2, 5, 5}));
-  ASSERT_EQ(pf.factors(11 * 11), std::vector<prime>({11, 11}));
-  ASSERT_EQ(pf.factors(11 * 17), std::vector<prime>({11, 17}));
+  ASSERT_EQ(pf.factors(11), std::vector<prime_t>{11});
+  ASSERT_EQ(pf.factors(15), std::vector<prime_t>({3, 5}));
+  ASSERT_EQ(pf.factors(50), std::vector<prime_t>({2, 5, 5}));
+  ASSERT_EQ(pf.factors(11 * 11), std::vector<prime_t>({11, 11}));
+  ASSERT_EQ(pf.factors(11 * 17), std::vector<prime_t>({11, 17}));
 }
 
 TEST(PrimeTest, Factors)
@@ -99,3 +113,186 @@ TEST(PrimeTest, IsPrime)
   ASSERT_TRUE(pf.is_prime(121021));
   ASSERT_TRUE(pf.is_prime(1e9 + 7));
 }
+
+TEST(PrimeTest, LargeFactorsAboveTrialBound)
+{
+  PrimeSieve<1000> pf;
+
+  ASSERT_TRUE(pf.is_prime(18446744073709551557ULL)); // largest 64-bit prime
+  ASSERT_TRUE(pf.is_prime((1ULL << 61) - 1));
+  ASSERT_FALSE(pf.is_prime(3215031751ULL)); // strong pseudoprime to bases 2, 3, 5, 7
+  ASSERT_FALSE(pf.is_prime(3825123056546413051ULL));
+  ASSERT_FALSE(pf.is_prime(4294967291ULL * 4294967279ULL));
+
+  ASSERT_EQ(pf.factors(4294967291ULL * 4294967279ULL), (std::vector<prime_t>{4294967279ULL, 4294967291ULL}));
+  ASSERT_EQ(pf.factors(1000003ULL * 1000003ULL * 17), (std::vector<prime_t>{17, 1000003ULL, 1000003ULL}));
+  ASSERT_EQ(pf.factors(999999000001ULL * 3 * 3), (std::vector<prime_t>{3, 3, 999999000001ULL}));
+  ASSERT_EQ(pf.distinct_factors(101ULL * 101 * 1009 * 1009 * 10007),
+            (std::vector<prime_t>{101, 1009, 10007}));
+}
+
+TEST(PrimeTest, FactorsMultiplyBack)
+{
+  PrimeSieve<1000> pf;
+  std::mt19937_64 rng(2024);
+  for (int i = 0; i < 2000; ++i)
+  {
+    uint64_t n       = rng() >> (i % 40);
+    auto fs          = pf.factors(n);
+    uint64_t product = 1;
+    for (auto p : fs)
+    {
+      ASSERT_TRUE(prime::miller_rabin(p)) << n;
+      product *= p;
+    }
+    ASSERT_EQ(product, n);
+    ASSERT_TRUE(std::is_sorted(fs.begin(), fs.end())) << n;
+  }
+}
+
+TEST(PrimeTest, SmallFactorListMatchesVector)
+{
+  PrimeSieve<1000> pf;
+  std::mt19937_64 rng(7);
+  for (int i = 0; i < 2000; ++i)
+  {
+    uint64_t n = rng() >> (i % 40);
+    auto small = pf.small_factors_freq(n);
+    auto freq  = pf.vector_factors_freq(n);
+    ASSERT_TRUE(std::ranges::equal(small, freq)) << n;
+
+    std::vector<std::pair<prime_t, uint64_t>> visited;
+    pf.for_each_prime_power(n, [&](prime_t p, uint64_t e) { visited.emplace_back(p, e); });
+    ASSERT_EQ(visited, freq) << n;
+  }
+
+  // primorial of the first 15 primes fills every slot
+  uint64_t primorial = 614889782588491410ULL;
+  auto full          = pf.small_factors_freq(primorial);
+  ASSERT_EQ(full.size(), SmallFactorList::cCapacity);
+  ASSERT_EQ(full.back(), (std::pair<uint64_t, uint64_t>{47, 1}));
+  ASSERT_TRUE(pf.small_factors_freq(1).empty());
+}
+
+TEST(PrimeTest, MillerRabinMatchesSieve)
+{
+  PrimeSieve<1'000'000> pf;
+  for (uint64_t n = 1; n <= 1'000'000; ++n) ASSERT_EQ(prime::miller_rabin(n), pf.is_prime(n)) << n;
+  for (uint64_t n : {561ULL, 1105ULL, 2047ULL, 1373653ULL, 25326001ULL, 3215031751ULL}) // pseudoprimes
+    EXPECT_FALSE(prime::miller_rabin(n)) << n;
+}
+
+TEST(PrimeTest, CompactStorageMatchesWide)
+{
+  PrimeSieve<10007> wide;
+  CompactPrimeSieve<10007> compact;
+
+  ASSERT_EQ(compact.all_primes(), wide.all_primes());
+  for (uint64_t n = 1; n <= 10007; ++n)
+  {
+    ASSERT_EQ(compact.is_prime(n), wide.is_prime(n)) << n;
+    ASSERT_EQ(compact.lowest_prime_factor(n), wide.lowest_prime_factor(n)) << n;
+    ASSERT_EQ(compact.factors(n), wide.factors(n)) << n;
+  }
+  for (uint64_t n : {10009ull, 10403ull, 1000000007ull, 11ull * 9901 * 99991})
+  {
+    EXPECT_EQ(compact.is_prime(n), wide.is_prime(n)) << n;
+    EXPECT_EQ(compact.factors(n), wide.factors(n)) << n;
+  }
+}
+
+TEST(PrimeTest, StaticSieveMatchesRuntime)
+{
+  constexpr uint64_t n = 100'000;
+  static constexpr StaticPrimeSieve<n> fixed;
+  PrimeSieve<n> sieve;
+
+  static_assert(fixed.is_prime(99991) && !fixed.is_prime(99999));
+  static_assert(fixed.lowest_prime_factor(3 * 33331) == 3);
+  static_assert(maya::primes_upto<n>().size() == 9592);
+
+  ASSERT_TRUE(std::ranges::equal(fixed.all_primes(), sieve.all_primes()));
+  for (uint64_t i = 1; i <= n; ++i)
+  {
+    ASSERT_EQ(fixed.is_prime(i), sieve.is_prime(i)) << i;
+    ASSERT_EQ(fixed.factors(i), sieve.factors(i)) << i;
+  }
+  for (uint64_t i : {100'003ull, 100'160'063ull, 1'000'000'007ull, 11ull * 9901 * 99991})
+  {
+    EXPECT_EQ(fixed.is_prime(i), sieve.is_prime(i)) << i;
+    EXPECT_EQ(fixed.factors(i), sieve.factors(i)) << i;
+  }
+}
+
+TEST(PrimeTest, ParallelBuildMatchesSerial)
+{
+  constexpr uint64_t N = 1'000'003;
+  PrimeSieve<N> serial;
+  PrimeSieve<N> wide{prime::ParallelBuild{}};
+  CompactPrimeSieve<N> compact{prime::ParallelBuild{.maxThreads = 3}};
+
+  ASSERT_EQ(wide.all_primes(), serial.all_primes());
+  ASSERT_EQ(compact.all_primes(), serial.all_primes());
+  for (uint64_t n = 0; n <= N; ++n)
+  {
+    ASSERT_EQ(wide.lowest_prime_factor(n), serial.lowest_prime_factor(n)) << n;
+    ASSERT_EQ(compact.lowest_prime_factor(n), serial.lowest_prime_factor(n)) << n;
+  }
+}
+
+TEST(PrimeTest, CacheFileRoundTrip)
+{
+  namespace fs  = std::filesystem;
+  const auto dir = fs::temp_directory_path() / ("prime-cache-test-" + std::to_string(::getpid()));
+  fs::create_directories(dir);
+
+  constexpr uint64_t N = 100'003;
+  PrimeSieve<N> reference;
+
+  const auto check = [&](const auto& pf)
+  {
+    ASSERT_EQ(pf.all_primes(), reference.all_primes());
+    for (uint64_t n = 1; n <= N; ++n) ASSERT_EQ(pf.lowest_prime_factor(n), reference.lowest_prime_factor(n));
+    EXPECT_EQ(pf.factors(1000003ULL * 999983), (std::vector<prime_t>{999983, 1000003}));
+  };
+
+  PrimeSieve<N> written{prime::CacheFile{.dir = dir}}; // miss: builds and writes
+  check(written);
+  PrimeSieve<N> mapped{prime::CacheFile{.dir = dir}}; // hit: maps
+  check(mapped);
+  PrimeSieve<N> copied = mapped;
+  check(copied);
+  CompactPrimeSieve<N> compact{prime::CacheFile{.dir = dir}};
+  CompactPrimeSieve<N> compactMapped{prime::CacheFile{.dir = dir}};
+  check(compactMapped);
+
+  // a corrupted file is rejected and rebuilt
+  const auto path = dir / ("prime-sieve-wide-" + std::to_string(N) + ".bin");
+  {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(200);
+    f.put(42);
+  }
+  PrimeSieve<N> rebuilt{prime::CacheFile{.dir = dir}};
+  check(rebuilt);
+  PrimeSieve<N> remapped{prime::CacheFile{.dir = dir}};
+  check(remapped);
+
+  fs::remove_all(dir);
+}
+
+TEST(PrimeTest, CacheChecksumStreams)
+{
+  // write_cache checksums table, pad and primes piece by piece; load_cache checksums the whole mapping
+  std::vector<unsigned char> bytes(1000);
+  std::iota(bytes.begin(), bytes.end(), 0);
+  for (size_t cut : {0, 1, 7, 8, 13, 999})
+  {
+    const size_t mid = (cut + bytes.size()) / 2;
+    hash::Checksum c(bytes.size());
+    c.update(bytes.data(), cut);
+    c.update(bytes.data() + cut, mid - cut);
+    c.update(bytes.data() + mid, bytes.size() - mid);
+    EXPECT_EQ(c.digest(), hash::checksum(bytes.data(), bytes.size())) << cut;
+  }
+}
@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <optional>
+#include <stdexcept>
+#include <utils/Prime.hpp>
+
+TEST(PrimeBitmapTest, MatchesSieve)
+{
+  PrimeSieve<100'000> pf;
+  PrimeBitmap bm(100'000);
+  ASSERT_GE(bm.limit(), 100'000);
+  ASSERT_FALSE(bm.is_prime(0));
+  for (uint64_t n = 1; n < 100'000; ++n) ASSERT_EQ(bm.is_prime(n), pf.is_prime(n)) << n;
+
+  auto primes = pf.all_primes();
+  ASSERT_EQ(bm.prev_prime(2), 0);
+  for (uint64_t n = 0; n < 99'000; ++n)
+  {
+    auto above = std::upper_bound(primes.begin(), primes.end(), n);
+    auto below = std::lower_bound(primes.begin(), primes.end(), n);
+    ASSERT_EQ(bm.next_prime(n), *above) << n;
+    ASSERT_EQ(bm.prev_prime(n), below == primes.begin() ? 0 : *std::prev(below)) << n;
+  }
+}
+
+TEST(PrimeBitmapTest, ExtendInSteps)
+{
+  PrimeBitmap grown;
+  for (uint64_t limit : {0, 1, 31, 1000, 1'000'000, 3'000'001}) grown.extend(limit);
+  PrimeBitmap fresh(3'000'001);
+  ASSERT_EQ(grown.limit(), fresh.limit());
+  for (uint64_t n = 0; n < fresh.limit(); ++n) ASSERT_EQ(grown.is_prime(n), fresh.is_prime(n)) << n;
+
+  EXPECT_EQ(fresh.next_prime(2'999'990), 2'999'999);
+  EXPECT_EQ(fresh.prev_prime(2'999'999), 2'999'957);
+  EXPECT_THROW((void)fresh.is_prime(fresh.limit()), std::out_of_range);
+  EXPECT_THROW((void)PrimeBitmap(100).next_prime(113), std::out_of_range);
+  EXPECT_EQ(PrimeBitmap(100).find_next_prime(113), std::nullopt);
+  EXPECT_EQ(PrimeBitmap(120).find_next_prime(113), std::nullopt); // 127 is past the limit
+  EXPECT_EQ(PrimeBitmap(150).find_next_prime(113), 127u);
+}
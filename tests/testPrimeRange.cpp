@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <ranges>
+#include <utils/Prime.hpp>
+
+TEST(PrimeRangeTest, MatchesSieve)
+{
+  PrimeSieve<100000> pf;
+  static_assert(std::ranges::input_range<PrimeRange>);
+
+  const auto doTest = [&](uint64_t lo, uint64_t hi)
+  {
+    std::vector<uint64_t> expected;
+    for (uint64_t p : pf.all_primes())
+      if (lo <= p && p < hi) expected.push_back(p);
+
+    std::vector<uint64_t> streamed;
+    for (uint64_t p : PrimeRange(lo, hi)) streamed.push_back(p);
+    EXPECT_EQ(streamed, expected) << "[" << lo << ", " << hi << ")";
+  };
+
+  doTest(0, 100000);
+  doTest(2, 3);
+  doTest(3, 3);
+  doTest(10, 5);
+  doTest(0, 2);
+  doTest(4, 30);
+  doTest(97, 98);
+  doTest(1000, 1009);
+  doTest(1000, 1010);
+  doTest(12345, 99999);
+}
+
+TEST(PrimeRangeTest, MultipleSegments)
+{
+  uint64_t count = 0;
+  for (uint64_t p : PrimeRange(0, 10'000'000)) count += (p != 0);
+  EXPECT_EQ(count, 664579);
+}
+
+TEST(PrimeRangeTest, FarWindow)
+{
+  PrimeSieve<1000> pf;
+  constexpr uint64_t lo = 1'000'000'000'000ULL;
+  constexpr uint64_t hi = lo + 2000;
+
+  std::vector<uint64_t> expected;
+  for (uint64_t n = lo; n < hi; ++n)
+    if (pf.is_prime(n)) expected.push_back(n);
+
+  std::vector<uint64_t> streamed;
+  for (uint64_t p : PrimeRange(lo, hi)) streamed.push_back(p);
+  EXPECT_EQ(streamed, expected);
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <ranges>
+#include <stdexcept>
+#include <utils/Prime.hpp>
+
+TEST(PrimeSumsTest, MatchesSieve)
+{
+  PrimeSieve<200'000> pf;
+  for (uint64_t x : {0, 1, 2, 3, 4, 10, 97, 100, 1000, 65'536, 199'999})
+  {
+    uint64_t count = 0;
+    unsigned __int128 sum = 0, squares = 0;
+    for (uint64_t p = 2; p <= x; ++p)
+      if (pf.is_prime(p))
+      {
+        ++count;
+        sum += p;
+        squares += p * p;
+      }
+
+    PrimeSums<0> pi(x);
+    PrimeSums<2> sq(x);
+    ASSERT_EQ(pi(x), count) << x;
+    ASSERT_TRUE(PrimeSums<1>(x)(x) == sum) << x;
+    ASSERT_TRUE(sq(x) == squares) << x;
+    for (uint64_t n = 1; n <= x; n = n * 3 + 1)
+      ASSERT_EQ(pi(x / n), std::ranges::count_if(pf.all_primes(), [&](uint64_t p) { return p <= x / n; }));
+  }
+}
+
+TEST(PrimeSumsTest, KnownValues)
+{
+  EXPECT_EQ(prime::pi(10'000'000'000), 455'052'511);
+  EXPECT_EQ(PrimeSums<0>(10'000'000'000, 1)(10'000'000'000), 455'052'511);
+  EXPECT_TRUE(prime::sum(1'000'000) == 37'550'402'023);
+  // sum of primes below 1e10 is 2220822432581729238, past what a double holds exactly
+  EXPECT_TRUE(prime::sum(10'000'000'000) == 2'220'822'432'581'729'238ULL);
+  EXPECT_THROW(PrimeSums<0>(PrimeSums<0>::cMaxX + 1), std::invalid_argument);
+  // rejected before 2^32-entry tables are sized off it
+  EXPECT_THROW(PrimeSums<0>(UINT64_MAX), std::invalid_argument);
+  EXPECT_THROW((void)PrimeSums<0>(1000)(499), std::invalid_argument);
+}
@@ -0,0 +1,80 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <random>
+#include <utils/Ntt.hpp>
+#include <utils/Recurrence.hpp>
+#include <utils/Utils.hpp>
+
+constexpr uint32_t P0 = ntt::cPrimes[0], P1 = ntt::cPrimes[1], P2 = ntt::cPrimes[2];
+using Rec = LinearRecurrence<P0, P1, P2>;
+using M   = Rec::M;
+
+TEST(RecurrenceTest, FindsFibonacciAndJumps)
+{
+  std::vector<uint64_t> fib{0, 1};
+  while (fib.size() < 90) fib.push_back(fib[fib.size() - 1] + fib[fib.size() - 2]);
+
+  const auto rec = Rec::find(std::vector<uint64_t>(fib.begin(), fib.begin() + 10));
+  ASSERT_TRUE(rec.has_value());
+  EXPECT_EQ(rec->order(), 2u);
+  EXPECT_EQ(rec->coefficients(), (std::vector<M>{M(1), M(1)}));
+  for (size_t n = 0; n < fib.size(); ++n) EXPECT_EQ(ntt::reconstruct(rec->nth(n)), fib[n]) << n;
+
+  // F(2n) = F(n) (2 F(n+1) - F(n)), all mod each prime
+  const uint64_t n = uint64_t{1} << 60;
+  EXPECT_EQ(rec->nth(2 * n), rec->nth(n) * (M(2) * rec->nth(n + 1) - rec->nth(n)));
+}
+
+TEST(RecurrenceTest, RandomRecurrenceMatchesIteration)
+{
+  std::mt19937 rng(21);
+  for (size_t d : {1, 5, 40, 300})
+  {
+    std::vector<M> coeffs(d), terms(4 * d + 10);
+    for (auto& c : coeffs) c = M(rng());
+    for (size_t i = 0; i < d; ++i) terms[i] = M(rng());
+    for (size_t i = d; i < terms.size(); ++i)
+      for (size_t j = 0; j < d; ++j) terms[i] += coeffs[j] * terms[i - 1 - j];
+
+    const auto rec = Rec::find(std::vector<M>(terms.begin(), terms.begin() + 2 * d + 1));
+    ASSERT_TRUE(rec.has_value()) << d;
+    EXPECT_EQ(rec->order(), d);
+    EXPECT_EQ(rec->coefficients(), coeffs);
+    for (size_t n = 0; n < terms.size(); ++n) EXPECT_EQ(rec->nth(n), terms[n]) << d << ' ' << n;
+  }
+}
+
+TEST(RecurrenceTest, TooFewTerms)
+{
+  EXPECT_FALSE(Rec::find(std::vector<int>{1, 2, 4, 8, 16, 31}).has_value());
+  EXPECT_FALSE(Rec::find(std::vector<int>{}).has_value());
+
+  // all zeros is the empty recurrence
+  const auto zero = Rec::find(std::vector<int>(5, 0));
+  ASSERT_TRUE(zero.has_value());
+  EXPECT_EQ(zero->order(), 0u);
+  EXPECT_EQ(zero->nth(1'000'000), M(0));
+
+  EXPECT_THROW(Rec({M(1)}, {M(1), M(1)}), std::invalid_argument);
+}
+
+TEST(RecurrenceTest, FromBfile)
+{
+  // a(n) = 3 a(n-1) - a(n-2) + 2 a(n-3)
+  std::vector<uint64_t> a{1, 2, 7};
+  while (a.size() < 30) a.push_back(3 * a[a.size() - 1] - a[a.size() - 2] + 2 * a[a.size() - 3]);
+
+  const auto path = std::filesystem::temp_directory_path() / "b_recurrence_test.txt";
+  {
+    std::ofstream out(path);
+    out << "# test\n";
+    for (size_t i = 0; i < 20; ++i) out << i << ' ' << a[i] << '\n';
+  }
+  const auto rec = Rec::find(utils::read_bfile<uint64_t>(path.string()));
+  std::filesystem::remove(path);
+
+  ASSERT_TRUE(rec.has_value());
+  EXPECT_EQ(rec->order(), 3u);
+  for (size_t n = 0; n < a.size(); ++n) EXPECT_EQ(ntt::reconstruct(rec->nth(n)), a[n]) << n;
+}
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <map>
+#include <stdexcept>
+#include <utils/Prime.hpp>
+
+TEST(SmoothNumbersTest, MatchesSieve)
+{
+  constexpr uint64_t n = 100'000;
+  PrimeSieve<n> sieve;
+  for (uint64_t y : {2, 7, 97, 1000})
+  {
+    SmoothNumbers smooth(n, y);
+    std::vector<uint64_t> expected;
+    std::map<uint64_t, std::vector<uint64_t>> byLargest;
+    for (uint64_t i = 1; i <= n; ++i)
+    {
+      uint64_t p = sieve.highest_prime_factor(i);
+      if (p > y) continue;
+      expected.push_back(i);
+      if (i > 1) byLargest[p].push_back(i);
+    }
+
+    ASSERT_EQ(smooth.sorted(), expected) << y;
+    for (uint64_t p : smooth.primes())
+    {
+      std::vector<uint64_t> group;
+      smooth.for_each_with_largest(p, [&](uint64_t v) { group.push_back(v); });
+      std::ranges::sort(group);
+      ASSERT_EQ(group, byLargest[p]) << y << ' ' << p;
+    }
+    for (uint64_t i = 1; i <= 1000; ++i) ASSERT_EQ(smooth.is_smooth(i), sieve.highest_prime_factor(i) <= y);
+  }
+}
+
+TEST(SmoothNumbersTest, NoOverflowAtTheTop)
+{
+  size_t count = 0;
+  SmoothNumbers(UINT64_MAX, 2).for_each([&](uint64_t) { ++count; });
+  EXPECT_EQ(count, 64);
+
+  std::vector<uint64_t> threes;
+  SmoothNumbers(UINT64_MAX, 3).for_each_with_largest(3, [&](uint64_t v) { threes.push_back(v); });
+  EXPECT_TRUE(std::ranges::all_of(threes, [](uint64_t v) { return v % 3 == 0; }));
+  EXPECT_THROW(SmoothNumbers(100, 10).for_each_with_largest(9, [](uint64_t) {}), std::invalid_argument);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <utils/Sumset.hpp>
+
+static std::vector<uint64_t> naive_counts(const std::vector<uint64_t>& members, size_t limit)
+{
+  std::vector<uint64_t> r(limit, 0);
+  for (uint64_t a : members)
+    for (uint64_t b : members)
+      if (a + b < limit) ++r[a + b];
+  return r;
+}
+
+TEST(SumsetCounterTest, SparseAndDenseUpdatesMatchNaive)
+{
+  constexpr size_t N = 3000;
+  std::mt19937 rng(4);
+  SumsetCounter sums(N);
+  std::vector<uint64_t> all;
+
+  // single elements and small batches stay sparse, the big ones go through the transform
+  for (size_t batch : {1, 1, 5, 40, 2000, 3, 800, 1})
+  {
+    std::vector<uint64_t> delta(batch);
+    for (auto& x : delta) x = rng() % N;
+    sums.insert(delta);
+    for (uint64_t x : delta)
+      if (std::ranges::find(all, x) == all.end()) all.push_back(x);
+
+    ASSERT_EQ(sums.members().size(), all.size());
+    ASSERT_EQ(sums.counts(), naive_counts(all, 2 * N - 1)) << batch;
+  }
+  EXPECT_THROW(sums.insert(N), std::out_of_range);
+}
+
+TEST(SumsetCounterTest, FirstZero)
+{
+  SumsetCounter sums(200, 200);
+  EXPECT_EQ(sums.first_zero(), 0);
+  EXPECT_EQ(sums.first_zero(199), 199);
+  EXPECT_EQ(sums.first_zero(200), std::nullopt);
+
+  sums.insert(std::vector<uint64_t>{0, 1});
+  EXPECT_EQ(sums.first_zero(), 3);
+  // 0..69 reach every sum below 139, the zero bits past the first word must be found too
+  std::vector<uint64_t> run(70);
+  std::iota(run.begin(), run.end(), 0);
+  sums.insert(run);
+  EXPECT_EQ(sums.first_zero(), 139);
+  EXPECT_EQ(sums.first_zero(150), 150);
+
+  for (uint64_t x = 70; x < 200; ++x) sums.insert(x);
+  EXPECT_EQ(sums.first_zero(), std::nullopt);
+}
+
+TEST(SumsetEngineTest, PairCountsMatchNaive)
+{
+  std::mt19937 rng(8);
+  // one partial word, several words with a ragged end, and past the transform crossover
+  for (size_t n : {size_t{1}, size_t{37}, size_t{1000}, SumsetEngine::cFftCrossover + 321})
+  {
+    SumsetEngine engine(n);
+    std::vector<uint64_t> members;
+    for (size_t a = 0; a < n; ++a)
+      if (rng() % 3 == 0)
+      {
+        engine.set(a);
+        members.push_back(a);
+      }
+    const auto expected = naive_counts(members, 2 * n - 1);
+
+    ASSERT_EQ(engine.sum_counts(), expected) << n;
+    for (fft::Simd simd : {fft::Simd::Scalar, fft::Simd::Avx2, fft::Simd::Avx512})
+    {
+      if (simd > fft::best_simd()) continue;
+      for (size_t t = 0; t < 2 * n - 1; t += 1 + t / 64)
+      {
+        ASSERT_EQ(engine.sum_count(t, simd), expected[t]) << n << ' ' << t << ' ' << fft::to_string(simd);
+        ASSERT_EQ(engine.has_sum(t, simd), expected[t] > 0) << n << ' ' << t << ' ' << fft::to_string(simd);
+      }
+    }
+    EXPECT_FALSE(engine.has_sum(2 * n));
+
+    std::vector<uint64_t> targets(2 * n + 5);
+    std::iota(targets.begin(), targets.end(), 0);
+    const auto batch = engine.has_sums(targets, 4);
+    for (size_t t = 0; t < targets.size(); ++t)
+      EXPECT_EQ(batch[t] != 0, t + 1 < 2 * n && expected[t] > 0) << t;
+  }
+}
+
+TEST(SumsetEngineTest, DifferenceCountsMatchNaive)
+{
+  std::mt19937 rng(21);
+  for (auto [n, m] : {std::pair<size_t, size_t>{1, 1}, {70, 200}, {513, 64}, {5000, 4500}})
+  {
+    SumsetEngine a(n), b(m);
+    std::vector<uint64_t> as, bs;
+    for (size_t x = 0; x < n; ++x)
+      if (rng() % 2) a.set(x), as.push_back(x);
+    for (size_t x = 0; x < m; ++x)
+      if (rng() % 2) b.set(x), bs.push_back(x);
+
+    std::vector<uint64_t> expected(n + m - 1, 0);
+    for (uint64_t x : as)
+      for (uint64_t y : bs) ++expected[x + (m - 1) - y];
+    EXPECT_EQ(a.difference_counts(b), expected) << n << ' ' << m;
+  }
+
+  SumsetEngine e(10);
+  EXPECT_THROW(e.set(10), std::out_of_range);
+  e.set(3);
+  e.reset(3);
+  EXPECT_FALSE(e.test(3));
+  EXPECT_EQ(e.sum_count(6), 0);
+}
@@ -1,13 +1,23 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <cmath>
 #include <complex>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <numbers>
+#include <stdexcept>
+#include <tuple>
 #include <vector>
 
+#include <utils/FftSimd.hpp>
 #include <utils/Logging.hpp>
+#include <utils/Parallel.hpp>
 
 namespace fft {
 
@@ -16,14 +26,14 @@ using cd = std::complex<double>;
 template <std::integral T> [[nodiscard]] std::vector<T> round(const std::vector<cd>& v)
 {
   std::vector<T> result;
-  for (size_t i = 0; i < v.size(); i++) result.push_back(static_cast<T>(v[i].real() + 0.5));
+  for (size_t i = 0; i < v.size(); i++) result.push_back(static_cast<T>(std::round(v[i].real())));
   return result;
 }
 
 template <std::integral T> [[nodiscard]] std::vector<T> round(const std::vector<double>& v)
 {
   std::vector<T> result;
-  for (size_t i = 0; i < v.size(); i++) result.push_back(static_cast<T>(v[i] + 0.5));
+  for (size_t i = 0; i < v.size(); i++) result.push_back(static_cast<T>(std::round(v[i])));
   return result;
 }
 
@@ -82,32 +92,501 @@ enum class Direction
   Inverse,
 };
 
-template <Direction Dir> void transform(std::vector<cd>& a)
+namespace detail {
+
+// spelled out: cd's operator* goes through the NaN-checking __muldc3
+[[nodiscard]] inline cd mul(cd x, cd y)
+{
+  return cd(x.real() * y.real() - x.imag() * y.imag(), x.real() * y.imag() + x.imag() * y.real());
+}
+
+} // namespace detail
+
+/* FftPlan
+ * - the bit reversal permutation and twiddles of one power-of-two size, built once and reused
+ * - plan(n) hands out a shared plan per size from a process-wide cache, safe to call from any thread;
+ *   transform() and the convolutions go through it, so repeated sizes pay the sin/cos setup once
+ * - execute() splits the input into aligned real and imaginary arrays and runs the radix-4 kernels of
+ *   FftSimd.hpp at the widest width the CPU has, unless a narrower one is asked for
+ * - from cFourStepMin up, sizes past a typical L3, n = n1 n2 goes four-step: the input as n2 rows of n1,
+ *   its columns transformed cColumns at a time, a twiddle by w^(j1 k2), its rows transformed in place and
+ *   one transpose to natural order. Every sub-transform fits in cache and the batches run in parallel;
+ *   the plan holds O(sqrt n) tables and execute() one buffer the size of the input, where a direct
+ *   plan of 2^28 points would carry 5 GB of permutation and roots plus 4 GB of scratch
+ * */
+class FftPlan
 {
-  size_t n = a.size();
-  assert((n & (n - 1)) == 0 && "input size is not power of 2");
+public:
+  static constexpr size_t cFourStepMin = size_t{1} << 21;
+
+  explicit FftPlan(size_t n, size_t fourStepMin = cFourStepMin) : mSize(n)
+  {
+    if (!std::has_single_bit(n)) throw std::invalid_argument("FftPlan: size is not a power of 2");
+    if (n >= fourStepMin && n >= 4)
+    {
+      const size_t n1 = size_t{1} << (std::countr_zero(n) / 2), n2 = n / n1;
+      mInner          = std::make_unique<const FftPlan>(n2);
+      mOuter          = std::make_unique<const FftPlan>(n1);
+      // w^m = mTwiddleHi[m / n2] mTwiddleLo[m % n2], both straight from polar so no error builds up
+      mTwiddleLo.resize(n2);
+      mTwiddleHi.resize(n1);
+      for (size_t i = 0; i < n2; ++i) mTwiddleLo[i] = std::polar(1.0, 2 * std::numbers::pi * i / n);
+      for (size_t i = 0; i < n1; ++i) mTwiddleHi[i] = std::polar(1.0, 2 * std::numbers::pi * i / n1);
+      return;
+    }
 
-  auto rev   = reverse_bit(n);
-  auto roots = unity_roots(n);
+    const auto roots = unity_roots(n);
+    mRootRe.resize(roots.size());
+    mRootIm.resize(roots.size());
+    for (size_t i = 0; i < roots.size(); ++i)
+    {
+      mRootRe[i] = roots[i].real();
+      mRootIm[i] = roots[i].imag();
+    }
+    if (n == 1)
+    {
+      mRev = {0};
+      return;
+    }
+    const auto rev = reverse_bit(n);
+    mRev.assign(rev.begin(), rev.end());
+  }
 
-  for (size_t i = 0; i < n; i++)
-    if (i < rev[i]) swap(a[i], a[rev[i]]);
+  [[nodiscard]] size_t size() const { return mSize; }
+  [[nodiscard]] bool four_step() const { return mInner != nullptr; }
 
-  for (size_t len = 1; len < n; len <<= 1)
-    for (size_t i = 0; i < n; i += 2 * len)
-      for (size_t j = 0; j < len; j++)
+  template <Direction Dir> void execute(std::vector<cd>& a, Simd simd = best_simd()) const
+  {
+    assert(a.size() == mSize && "input size doesn't match the plan");
+    if (!four_step())
+    {
+      detail::AlignedDoubles re(mSize), im(mSize);
+      execute_direct<Dir>(a.data(), re.data(), im.data(), simd);
+      return;
+    }
+
+    execute_four_step(a, simd);
+    if constexpr (Dir == Direction::Inverse)
+    {
+      std::reverse(a.begin() + 1, a.end());
+      for (cd& x : a) x /= static_cast<double>(mSize);
+    }
+  }
+
+private:
+  // the in-cache transform on a, re and im being scratch of size()
+  template <Direction Dir> void execute_direct(cd* a, double* re, double* im, Simd simd) const
+  {
+    const size_t n = mSize;
+    for (size_t i = 0; i < n; i++)
+    {
+      re[i] = a[mRev[i]].real();
+      im[i] = a[mRev[i]].imag();
+    }
+
+    detail::run_passes(re, im, mRootRe.data(), mRootIm.data(), n, simd);
+
+    if constexpr (Dir == Direction::Forward)
+      for (size_t i = 0; i < n; i++) a[i] = cd(re[i], im[i]);
+    else
+      // the inverse is the forward transform read backwards, X[-k] / n
+      for (size_t i = 0, k = 0; i < n; i++, k = n - i) a[i] = cd(re[k], im[k]) / static_cast<double>(n);
+  }
+
+  // j = j1 + n1 j2 and k = k2 + n2 k1: X[k] = sum_j1 w_n1^(j1 k1) w^(j1 k2) sum_j2 w_n2^(j2 k2) x[j]
+  void execute_four_step(std::vector<cd>& a, Simd simd) const
+  {
+    constexpr size_t cColumns = 16;
+    const size_t n2 = mInner->size(), n1 = mOuter->size(), batch = std::min(cColumns, n1);
+    const int shift = std::countr_zero(n2);
+
+    // columns j1: each row contributes whole cache lines to a batch, so the stride costs no extra traffic
+    std::vector<size_t> starts;
+    for (size_t c = 0; c < n1; c += batch) starts.push_back(c);
+    utils::parallel::foreach (starts, [&](size_t c0)
+    {
+      detail::AlignedDoubles re(batch * n2), im(batch * n2);
+      for (size_t i = 0; i < n2; ++i)
+      {
+        const cd* src = a.data() + mInner->mRev[i] * n1 + c0;
+        for (size_t b = 0; b < batch; ++b)
+        {
+          re[b * n2 + i] = src[b].real();
+          im[b * n2 + i] = src[b].imag();
+        }
+      }
+      for (size_t b = 0; b < batch; ++b)
+        detail::run_passes(re.data() + b * n2, im.data() + b * n2, mInner->mRootRe.data(),
+                           mInner->mRootIm.data(), n2, simd);
+      for (size_t k2 = 0; k2 < n2; ++k2)
       {
-        cd u           = a[i + j];
-        cd v           = a[i + j + len] * roots[len + j];
-        a[i + j]       = u + v;
-        a[i + j + len] = u - v;
+        cd* dst = a.data() + k2 * n1 + c0;
+        for (size_t b = 0, m = c0 * k2; b < batch; ++b, m += k2)
+        {
+          const cd w = detail::mul(mTwiddleHi[m >> shift], mTwiddleLo[m & (n2 - 1)]);
+          dst[b]     = detail::mul(cd(re[b * n2 + k2], im[b * n2 + k2]), w);
+        }
       }
+    });
 
-  if constexpr (Dir == Direction::Inverse)
+    // rows k2, contiguous
+    starts.clear();
+    for (size_t r = 0; r < n2; r += cColumns) starts.push_back(r);
+    utils::parallel::foreach (starts, [&](size_t r0)
+    {
+      detail::AlignedDoubles re(n1), im(n1);
+      for (size_t r = r0; r < std::min(r0 + cColumns, n2); ++r)
+        mOuter->execute_direct<Direction::Forward>(a.data() + r * n1, re.data(), im.data(), simd);
+    });
+
+    // X[k2 + n2 k1] sits at row k2, column k1; each batch of columns fills cColumns output rows in order
+    std::vector<cd> out(mSize);
+    starts.clear();
+    for (size_t c = 0; c < n1; c += batch) starts.push_back(c);
+    utils::parallel::foreach (starts, [&](size_t c0)
+    {
+      for (size_t k2 = 0; k2 < n2; ++k2)
+        for (size_t b = 0; b < batch; ++b) out[(c0 + b) * n2 + k2] = a[k2 * n1 + c0 + b];
+    });
+    a.swap(out);
+  }
+
+  size_t mSize;
+  std::vector<uint32_t> mRev;
+  detail::AlignedDoubles mRootRe, mRootIm;
+
+  std::unique_ptr<const FftPlan> mInner, mOuter;
+  std::vector<cd> mTwiddleLo, mTwiddleHi;
+};
+
+namespace detail {
+
+// one plan per power-of-two size, built by the first caller that needs it
+template <typename Plan> class PlanCache
+{
+public:
+  [[nodiscard]] std::shared_ptr<const Plan> get(size_t n)
+  {
+    std::lock_guard lock(mMutex);
+    auto& slot = mPlans[std::countr_zero(n)];
+    if (!slot) slot = std::make_shared<const Plan>(n);
+    return slot;
+  }
+
+  // plans still held by callers stay alive until they let go
+  void clear()
+  {
+    std::lock_guard lock(mMutex);
+    mPlans = {};
+  }
+
+private:
+  std::mutex mMutex;
+  std::array<std::shared_ptr<const Plan>, 64> mPlans;
+};
+
+[[nodiscard]] inline PlanCache<FftPlan>& plans()
+{
+  static PlanCache<FftPlan> cache;
+  return cache;
+}
+
+} // namespace detail
+
+[[nodiscard]] inline std::shared_ptr<const FftPlan> plan(size_t n)
+{
+  if (!std::has_single_bit(n)) throw std::invalid_argument("fft::plan: size is not a power of 2");
+  return detail::plans().get(n);
+}
+
+template <Direction Dir> void transform(std::vector<cd>& a)
+{
+  assert(std::has_single_bit(a.size()) && "input size is not power of 2");
+  plan(a.size())->execute<Dir>(a);
+}
+
+/* RealFftPlan
+ * - the transform of n real samples through one complex FftPlan of size n / 2: even samples ride in the
+ *   real part, odd ones in the imaginary part, and one twiddle pass untangles the two halves
+ * - spectra are packed into n / 2 slots: bin k in slot k, except the real bins 0 and n / 2,
+ *   which share slot 0 as (X[0], X[n / 2]); the other half follows from conjugate symmetry
+ * - half the arithmetic and half the memory of pushing real data through complex transforms
+ * */
+class RealFftPlan
+{
+public:
+  explicit RealFftPlan(size_t n) : mHalf(plan(std::max<size_t>(n / 2, 1))), mTwiddle(n / 4 + 1)
   {
-    std::reverse(a.begin() + 1, a.end());
-    for (cd& x : a) x /= n;
+    if (n < 2 || !std::has_single_bit(n))
+      throw std::invalid_argument("RealFftPlan: size is not a power of 2 above 1");
+    for (size_t k = 0; k < mTwiddle.size(); ++k) mTwiddle[k] = std::polar(1.0, 2 * std::numbers::pi * k / n);
   }
+
+  [[nodiscard]] size_t size() const { return 2 * mHalf->size(); }
+
+  // packed spectrum of x, zero padded to size()
+  template <typename T> [[nodiscard]] std::vector<cd> forward(const std::vector<T>& x) const
+  {
+    const size_t h = mHalf->size();
+    assert(x.size() <= 2 * h && "input longer than the plan");
+    std::vector<cd> z(h);
+    for (size_t i = 0; i < x.size(); ++i)
+      if (i % 2 == 0)
+        z[i / 2].real(static_cast<double>(x[i]));
+      else
+        z[i / 2].imag(static_cast<double>(x[i]));
+    mHalf->execute<Direction::Forward>(z);
+
+    // z = E + iO for the spectra E, O of the even and odd samples, X[k] = E[k] + w^k O[k]
+    z[0] = cd(z[0].real() + z[0].imag(), z[0].real() - z[0].imag());
+    for (size_t k = 1; 2 * k <= h; ++k)
+    {
+      const size_t j = h - k;
+      const cd e     = (z[k] + std::conj(z[j])) * 0.5;
+      const cd o     = (z[k] - std::conj(z[j])) * cd(0, -0.5) * mTwiddle[k];
+      z[k]           = e + o;
+      if (j != k) z[j] = std::conj(e - o);
+    }
+    return z;
+  }
+
+  // a *= b, slot by slot on packed spectra
+  void multiply(std::vector<cd>& a, const std::vector<cd>& b) const
+  {
+    a[0] = cd(a[0].real() * b[0].real(), a[0].imag() * b[0].imag());
+    for (size_t k = 1; k < a.size(); ++k) a[k] *= b[k];
+  }
+
+  // acc += a b, slot by slot on packed spectra
+  void multiply_add(std::vector<cd>& acc, const std::vector<cd>& a, const std::vector<cd>& b) const
+  {
+    acc[0] += cd(a[0].real() * b[0].real(), a[0].imag() * b[0].imag());
+    for (size_t k = 1; k < acc.size(); ++k) acc[k] += detail::mul(a[k], b[k]);
+  }
+
+  // the first count real samples behind a packed spectrum, which is used as scratch
+  [[nodiscard]] std::vector<double> inverse(std::vector<cd>& z, size_t count) const
+  {
+    const size_t h = mHalf->size();
+    assert(count <= 2 * h && "asking for more samples than the plan has");
+    z[0] = cd(z[0].real() + z[0].imag(), z[0].real() - z[0].imag()) * 0.5;
+    for (size_t k = 1; 2 * k <= h; ++k)
+    {
+      const size_t j = h - k;
+      const cd e     = (z[k] + std::conj(z[j])) * 0.5;
+      const cd o     = (z[k] - std::conj(z[j])) * 0.5 * std::conj(mTwiddle[k]);
+      z[k]           = e + cd(0, 1) * o;
+      if (j != k) z[j] = std::conj(e) + cd(0, 1) * std::conj(o);
+    }
+    mHalf->execute<Direction::Inverse>(z);
+
+    std::vector<double> x(count);
+    for (size_t i = 0; i < count; ++i) x[i] = i % 2 == 0 ? z[i / 2].real() : z[i / 2].imag();
+    return x;
+  }
+
+private:
+  std::shared_ptr<const FftPlan> mHalf;
+  std::vector<cd> mTwiddle; // w^k = e^(2 pi i k / n) for k <= n / 4
+};
+
+namespace detail {
+
+[[nodiscard]] inline PlanCache<RealFftPlan>& real_plans()
+{
+  static PlanCache<RealFftPlan> cache;
+  return cache;
+}
+
+} // namespace detail
+
+[[nodiscard]] inline std::shared_ptr<const RealFftPlan> real_plan(size_t n)
+{
+  if (n < 2 || !std::has_single_bit(n))
+    throw std::invalid_argument("fft::real_plan: size is not a power of 2 above 1");
+  return detail::real_plans().get(n);
+}
+
+// drops the cached plans, e.g. after a run of large sizes that won't come back
+inline void clear_plans()
+{
+  detail::plans().clear();
+  detail::real_plans().clear();
+}
+
+/* rounding_error_bound
+ * - a bound on |computed - exact| over every coefficient of a double precision convolution of size n,
+ *   first order in the unit roundoff u = 2^-53: |a|_2 |b|_2 u (3 (2 + sqrt 5) log2 n + sqrt 5), after
+ *   Percival's analysis of the radix-2 FFT; the norms make it O(n), far below the transforms themselves
+ * - integer results round correctly while it stays below 0.5; it's conservative, errors seen in
+ *   practice are a few orders smaller
+ * */
+[[nodiscard]] inline double rounding_error_bound(double normA, double normB, size_t n)
+{
+  const double u     = std::numeric_limits<double>::epsilon() / 2;
+  const double log2n = std::max(1.0, std::log2(static_cast<double>(n)));
+  const double sqrt5 = std::sqrt(5.0);
+  return normA * normB * u * (3 * (2 + sqrt5) * log2n + sqrt5);
+}
+
+namespace detail {
+
+template <typename T> [[nodiscard]] double norm2(const std::vector<T>& v)
+{
+  double sum = 0;
+  for (const T& x : v) sum += static_cast<double>(x) * static_cast<double>(x);
+  return std::sqrt(sum);
+}
+
+} // namespace detail
+
+template <typename T>
+  requires std::is_arithmetic_v<T>
+[[nodiscard]] double rounding_error_bound(const std::vector<T>& a, const std::vector<T>& b)
+{
+  const size_t n = round_up_to_binary_power(a.size() + b.size());
+  return rounding_error_bound(detail::norm2(a), detail::norm2(b), n);
+}
+
+namespace detail {
+
+// integer inputs whose products the doubles can't hold exactly are worth a line in the log
+template <typename T> void check_rounding(const std::vector<T>& a, const std::vector<T>& b)
+{
+  if constexpr (std::is_integral_v<T>)
+  {
+    const double bound = rounding_error_bound(a, b);
+    if (bound >= 0.5)
+      Log(LL::Warn, "fft::convolution: rounding error up to $, use exact_convolution for integers"_f, bound);
+  }
+}
+
+} // namespace detail
+
+// real input goes through RealFftPlan: half the work and memory of the complex path, real output
+template <typename T>
+  requires std::is_arithmetic_v<T>
+[[nodiscard]] std::vector<double> convolution(const std::vector<T>& a, const std::vector<T>& b)
+{
+  if (a.empty() || b.empty()) return {};
+  detail::check_rounding(a, b);
+  const auto p = real_plan(round_up_to_binary_power(a.size() + b.size()));
+  auto fa      = p->forward(a);
+  p->multiply(fa, p->forward(b));
+  return p->inverse(fa, a.size() + b.size() - 1);
+}
+
+template <typename T>
+  requires std::is_arithmetic_v<T>
+[[nodiscard]] std::vector<double> self_convolution(const std::vector<T>& a)
+{
+  if (a.empty()) return {};
+  detail::check_rounding(a, a);
+  const auto p = real_plan(round_up_to_binary_power(2 * a.size()));
+  auto fa      = p->forward(a);
+  p->multiply(fa, fa);
+  return p->inverse(fa, 2 * a.size() - 1);
+}
+
+namespace detail {
+
+// limb width, and limbs per side, for which every partial convolution rounds correctly
+struct LimbSplit
+{
+  int bits;
+  size_t limbsA, limbsB;
+};
+
+template <typename T>
+[[nodiscard]] LimbSplit choose_limbs(const std::vector<T>& a, const std::vector<T>& b, size_t n)
+{
+  const auto stats = [](const std::vector<T>& v)
+  {
+    if constexpr (std::is_signed_v<T>)
+      if (std::ranges::any_of(v, [](T x) { return x < 0; }))
+        throw std::invalid_argument("fft::exact_convolution: coefficients must be non-negative");
+    const auto top       = static_cast<uint64_t>(std::ranges::max(v));
+    const size_t nonzero = std::ranges::count_if(v, [](T x) { return x != 0; });
+    const int bits       = static_cast<int>(std::bit_width(top));
+    return std::tuple{bits, std::sqrt(static_cast<double>(nonzero)), norm2(v)};
+  };
+  const auto [bitsA, rootA, normA] = stats(a);
+  const auto [bitsB, rootB, normB] = stats(b);
+
+  // one limb while the whole values are safe, otherwise the widest limbs at or below 16 bits that are;
+  // a limb vector's norm is at most the value vector's, and at most sqrt(nonzero) (2^bits - 1)
+  const int widest = std::max({bitsA, bitsB, 1});
+  for (int bits = widest <= 53 ? widest : 16; bits >= 1; bits = std::min(bits - 1, 16))
+  {
+    const double limb      = std::ldexp(1.0, bits) - 1;
+    const size_t ka        = std::max<size_t>(1, (bitsA + bits - 1) / bits);
+    const size_t kb        = std::max<size_t>(1, (bitsB + bits - 1) / bits);
+    const double normLimbA = std::min(normA, rootA * limb), normLimbB = std::min(normB, rootB * limb);
+    const double terms     = static_cast<double>(std::min(ka, kb));
+    if (terms * rounding_error_bound(normLimbA, normLimbB, n) < 0.5) return {bits, ka, kb};
+  }
+  throw std::invalid_argument("fft::exact_convolution: input too long for double precision limbs");
+}
+
+template <std::integral T>
+[[nodiscard]] std::vector<uint64_t> exact_convolve(const std::vector<T>& a, const std::vector<T>& b,
+                                                   bool self)
+{
+  if (a.empty() || b.empty()) return {};
+  const size_t size  = a.size() + b.size() - 1;
+  const auto p       = real_plan(round_up_to_binary_power(a.size() + b.size()));
+  const auto split   = choose_limbs(a, b, p->size());
+  const uint64_t low = (uint64_t{1} << split.bits) - 1;
+
+  const auto spectra = [&](const std::vector<T>& v, size_t count)
+  {
+    std::vector<std::vector<cd>> limbs;
+    std::vector<uint64_t> limb(v.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+      const int shift = static_cast<int>(i) * split.bits;
+      for (size_t j = 0; j < v.size(); ++j) limb[j] = static_cast<uint64_t>(v[j]) >> shift & low;
+      limbs.push_back(p->forward(limb));
+    }
+    return limbs;
+  };
+  const auto fa    = spectra(a, split.limbsA);
+  const auto other = self ? decltype(fa){} : spectra(b, split.limbsB);
+  const auto& fb   = self ? fa : other;
+
+  // limb pairs (i, j) with the same i + j share one inverse transform, shifted in by (i + j) bits each
+  std::vector<uint64_t> result(size, 0);
+  for (size_t s = 0; s + 1 < split.limbsA + split.limbsB; ++s)
+  {
+    const size_t shift = s * split.bits;
+    if (shift >= 64) break;
+    std::vector<cd> acc(p->size() / 2);
+    for (size_t i = 0; i < split.limbsA; ++i)
+      if (s >= i && s - i < split.limbsB) p->multiply_add(acc, fa[i], fb[s - i]);
+    const auto part = p->inverse(acc, size);
+    for (size_t k = 0; k < size; ++k) result[k] += static_cast<uint64_t>(std::round(part[k])) << shift;
+  }
+  return result;
+}
+
+} // namespace detail
+
+/* exact_convolution
+ * - integer convolution with no rounding doubt: inputs are cut into limbs of at most 16 bits, every
+ *   group of limb products that lands on the same shift is one real transform, and the limb width
+ *   drops until rounding_error_bound says each of those rounds correctly
+ * - results are exact mod 2^64, so exact outright whenever the true coefficient fits in 64 bits
+ * - small inputs take a single limb, the cost of the plain path plus one pass for the bound
+ * */
+template <std::integral T>
+[[nodiscard]] std::vector<uint64_t> exact_convolution(const std::vector<T>& a, const std::vector<T>& b)
+{
+  return detail::exact_convolve(a, b, false);
+}
+
+template <std::integral T> [[nodiscard]] std::vector<uint64_t> exact_self_convolution(const std::vector<T>& a)
+{
+  return detail::exact_convolve(a, a, true);
 }
 
 template <typename T>
@@ -119,10 +598,11 @@ template <typename T>
   fa.resize(n);
   fb.resize(n);
 
-  transform<Direction::Forward>(fa);
-  transform<Direction::Forward>(fb);
+  const auto p = plan(n);
+  p->execute<Direction::Forward>(fa);
+  p->execute<Direction::Forward>(fb);
   for (size_t i = 0; i < n; i++) fa[i] *= fb[i];
-  transform<Direction::Inverse>(fa);
+  p->execute<Direction::Inverse>(fa);
 
   fa.resize(a.size() + b.size() - 1);
   return fa;
@@ -134,9 +614,10 @@ template <typename T> [[nodiscard]] std::vector<cd> self_convolution(const std::
   size_t n           = round_up_to_binary_power(2 * a.size());
   fa.resize(n);
 
-  transform<Direction::Forward>(fa);
+  const auto p = plan(n);
+  p->execute<Direction::Forward>(fa);
   for (size_t i = 0; i < n; i++) fa[i] *= fa[i];
-  transform<Direction::Inverse>(fa);
+  p->execute<Direction::Inverse>(fa);
 
   fa.resize(2 * a.size() - 1);
   return fa;
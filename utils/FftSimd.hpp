@@ -0,0 +1,174 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string_view>
+#include <vector>
+
+/* structure-of-arrays FFT kernels
+ * - real and imaginary parts live in separate 64-byte aligned arrays, so one vector register holds
+ *   4 (AVX2) or 8 (AVX-512) consecutive butterflies
+ * - radix-4 passes: two radix-2 stages fused, 3 complex multiplies per 4 points instead of 4
+ * - one generic kernel written with GCC vector extensions, instantiated per width inside functions
+ *   carrying the matching target attribute; the width is picked at runtime from the CPU features
+ * */
+namespace fft {
+
+enum class Simd
+{
+  Scalar,
+  Avx2,
+  Avx512,
+};
+
+[[nodiscard]] constexpr std::string_view to_string(Simd s)
+{
+  switch (s)
+  {
+  case Simd::Avx2: return "avx2";
+  case Simd::Avx512: return "avx512";
+  default: return "scalar";
+  }
+}
+
+// the widest kernel this CPU runs, detected once
+[[nodiscard]] inline Simd best_simd()
+{
+  static const Simd best = []
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Simd::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Simd::Avx2;
+#endif
+    return Simd::Scalar;
+  }();
+  return best;
+}
+
+namespace detail {
+
+inline constexpr std::align_val_t cSimdAlign{64};
+
+template <typename T> struct AlignedAllocator
+{
+  using value_type = T;
+
+  AlignedAllocator() = default;
+  template <typename U> AlignedAllocator(const AlignedAllocator<U>&) {}
+
+  [[nodiscard]] T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), cSimdAlign)); }
+  void deallocate(T* p, size_t) { ::operator delete(p, cSimdAlign); }
+  template <typename U> bool operator==(const AlignedAllocator<U>&) const { return true; }
+};
+
+using AlignedDoubles = std::vector<double, AlignedAllocator<double>>;
+
+// may_alias: the kernels view the double arrays through these
+using V1 = double;
+using V4 = double __attribute__((vector_size(4 * sizeof(double)), may_alias));
+using V8 = double __attribute__((vector_size(8 * sizeof(double)), may_alias));
+
+// stages len and 2 len of the radix-2 DIT on SoA data in bit reversed order, roots as in unity_roots.
+// V spans W = sizeof(V) / sizeof(double) consecutive j, so len must be a multiple of W and the arrays
+// W-aligned; vectors never cross a call boundary by value, which keeps every width ABI neutral
+template <typename V>
+[[gnu::always_inline]] inline void radix4_pass(double* re, double* im, const double* wr, const double* wi,
+                                               size_t n, size_t len)
+{
+  constexpr size_t W = sizeof(V) / sizeof(double);
+  const auto at       = [](double* p) -> V& { return *reinterpret_cast<V*>(p); };
+  const auto root     = [](const double* p) -> const V& { return *reinterpret_cast<const V*>(p); };
+
+  for (size_t i = 0; i < n; i += 4 * len)
+    for (size_t j = 0; j < len; j += W)
+    {
+      double *r = re + i + j, *m = im + i + j;
+      V a0r = at(r), a1r = at(r + len), a2r = at(r + 2 * len), a3r = at(r + 3 * len);
+      V a0i = at(m), a1i = at(m + len), a2i = at(m + 2 * len), a3i = at(m + 3 * len);
+      V w1r = root(wr + len + j), w1i = root(wi + len + j);
+      V w2r = root(wr + 2 * len + j), w2i = root(wi + 2 * len + j);
+
+      // stage len: (a0, a1) and (a2, a3), both by w1
+      V tr = w1r * a1r - w1i * a1i, ti = w1r * a1i + w1i * a1r;
+      V b0r = a0r + tr, b0i = a0i + ti, b1r = a0r - tr, b1i = a0i - ti;
+      tr    = w1r * a3r - w1i * a3i;
+      ti    = w1r * a3i + w1i * a3r;
+      V b2r = a2r + tr, b2i = a2i + ti, b3r = a2r - tr, b3i = a2i - ti;
+
+      // stage 2 len: (b0, b2) by w2 and (b1, b3) by w2 i
+      tr              = w2r * b2r - w2i * b2i;
+      ti              = w2r * b2i + w2i * b2r;
+      at(r)           = b0r + tr;
+      at(m)           = b0i + ti;
+      at(r + 2 * len) = b0r - tr;
+      at(m + 2 * len) = b0i - ti;
+      tr              = w2r * b3r - w2i * b3i;
+      ti              = w2r * b3i + w2i * b3r;
+      at(r + len)     = b1r - ti;
+      at(m + len)     = b1i + tr;
+      at(r + 3 * len) = b1r + ti;
+      at(m + 3 * len) = b1i - tr;
+    }
+}
+
+inline void radix4_pass_scalar(double* re, double* im, const double* wr, const double* wi, size_t n, size_t len)
+{
+  radix4_pass<V1>(re, im, wr, wi, n, len);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+[[gnu::target("avx2,fma")]] inline void radix4_pass_avx2(double* re, double* im, const double* wr,
+                                                         const double* wi, size_t n, size_t len)
+{
+  radix4_pass<V4>(re, im, wr, wi, n, len);
+}
+
+[[gnu::target("avx512f")]] inline void radix4_pass_avx512(double* re, double* im, const double* wr,
+                                                          const double* wi, size_t n, size_t len)
+{
+  radix4_pass<V8>(re, im, wr, wi, n, len);
+}
+#endif
+
+// every stage of the transform on data already in bit reversed order
+inline void run_passes(double* re, double* im, const double* wr, const double* wi, size_t n, Simd simd)
+{
+  size_t len = 1;
+  if (std::countr_zero(n) % 2 == 1)
+  {
+    // odd number of stages: a lone radix-2 stage, all of its roots are 1
+    for (size_t i = 0; i < n; i += 2)
+    {
+      double ur = re[i], ui = im[i];
+      re[i] += re[i + 1];
+      im[i] += im[i + 1];
+      re[i + 1] = ur - re[i + 1];
+      im[i + 1] = ui - im[i + 1];
+    }
+    len = 2;
+  }
+
+  for (; len < n; len *= 4)
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    if (simd == Simd::Avx512 && len % 8 == 0)
+    {
+      radix4_pass_avx512(re, im, wr, wi, n, len);
+      continue;
+    }
+    if (simd != Simd::Scalar && len % 4 == 0)
+    {
+      radix4_pass_avx2(re, im, wr, wi, n, len);
+      continue;
+    }
+#endif
+    radix4_pass_scalar(re, im, wr, wi, n, len);
+  }
+}
+
+} // namespace detail
+
+} // namespace fft
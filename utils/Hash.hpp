@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <utility>
 
@@ -18,6 +21,66 @@ template <typename... Ts> [[nodiscard]] size_t combine(const Ts&... vs)
   return seed;
 }
 
+// non-cryptographic checksum of raw memory, 8 bytes per step so it keeps up with a page-in.
+// Fed piece by piece it gives what checksum() gives on the concatenation; the total length is mixed in
+// first, so it has to be known up front
+class Checksum
+{
+public:
+  explicit Checksum(size_t bytes) : mHash(0x9e3779b97f4a7c15ULL ^ bytes) {}
+
+  void update(const void* data, size_t bytes)
+  {
+    const auto* p = static_cast<const unsigned char*>(data);
+    // top up the word a previous piece left partial
+    if (mPending > 0)
+    {
+      const size_t take = std::min(bytes, 8 - mPending);
+      std::memcpy(mWord + mPending, p, take);
+      mPending += take;
+      p += take;
+      bytes -= take;
+      if (mPending < 8) return;
+      mix_word(mWord);
+    }
+    for (; bytes >= 8; p += 8, bytes -= 8) mix_word(p);
+    std::memcpy(mWord, p, bytes);
+    mPending = bytes;
+  }
+
+  [[nodiscard]] uint64_t digest() const
+  {
+    uint64_t h = mHash;
+    for (size_t i = 0; i < mPending && i < 8; ++i) mix(h, mWord[i]);
+    return h;
+  }
+
+private:
+  static void mix(uint64_t& h, uint64_t w)
+  {
+    h = (h ^ w) * 0xff51afd7ed558ccdULL;
+    h ^= h >> 32;
+  }
+
+  void mix_word(const unsigned char* p)
+  {
+    uint64_t w;
+    std::memcpy(&w, p, 8);
+    mix(mHash, w);
+  }
+
+  uint64_t mHash;
+  unsigned char mWord[8] = {};
+  size_t mPending        = 0;
+};
+
+[[nodiscard]] inline uint64_t checksum(const void* data, size_t bytes)
+{
+  Checksum c(bytes);
+  c.update(data, bytes);
+  return c.digest();
+}
+
 template <typename T> struct Hasher
 {
   [[nodiscard]] size_t operator()(const T& v) const { return v.hash(); }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <fcntl.h>
+#include <filesystem>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace utils {
+
+/* MappedFile
+ * - read-only, shared mmap of a whole file; processes mapping the same file share its pages
+ * - open() returns nullptr when the file is missing or can't be mapped
+ * */
+class MappedFile
+{
+public:
+  [[nodiscard]] static std::shared_ptr<const MappedFile> open(const std::filesystem::path& path)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0)
+      data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+
+    if (data == MAP_FAILED) return nullptr;
+    return std::shared_ptr<const MappedFile>(new MappedFile(data, st.st_size));
+  }
+
+  ~MappedFile() { ::munmap(mData, mSize); }
+
+  MappedFile(const MappedFile&)            = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  [[nodiscard]] const std::byte* data() const { return static_cast<const std::byte*>(mData); }
+  [[nodiscard]] size_t size() const { return mSize; }
+
+private:
+  MappedFile(void* data, size_t size) : mData(data), mSize(size) {}
+
+  void* mData;
+  size_t mSize;
+};
+
+} // namespace utils
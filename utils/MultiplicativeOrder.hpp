@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <math/ModArith.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utils/Logging.hpp>
+#include <utils/Parallel.hpp>
+#include <utils/Prime.hpp>
+#include <vector>
+
+/* MultiplicativeOrder
+ * - ord_n(b) for every n <= N, 0 when gcd(n, b) > 1
+ * - primes: start from lambda(p) = p - 1 and strip each prime q of p - 1 while b^(t / q) stays 1,
+ *   factoring p - 1 through the sieve's allocation-free visitor, powers in Montgomery form
+ * - p^k: ord is ord(p^(k-1)) or p times it, one power decides
+ * - anything else: lcm of the orders of its prime-power parts
+ * - built in rounds [lo, 2 lo) that only read below lo, each round swept in parallel
+ * - for even b only odd n are stored, halving the table
+ * - can borrow a sieve the caller already holds and stop at a runtime limit below N
+ * */
+template <uint64_t N> class MultiplicativeOrder
+{
+public:
+  using order_t = std::conditional_t<(N < (uint64_t{1} << 32)), uint32_t, uint64_t>;
+
+  // values below this are filled on the calling thread, as is each round's chunk
+  static constexpr uint64_t cSegment = uint64_t{1} << 16;
+
+  explicit MultiplicativeOrder(uint64_t base, prime::ParallelBuild conf = {})
+      : MultiplicativeOrder(base, CompactPrimeSieve<N>{conf}, N, conf)
+  {
+  }
+
+  // orders up to limit <= N only, factoring through sieve, which must reach limit
+  template <typename Sieve>
+  MultiplicativeOrder(uint64_t base, const Sieve& sieve, uint64_t limit = N, prime::ParallelBuild conf = {});
+
+  [[nodiscard]] order_t operator()(uint64_t n) const
+  {
+    if (mOddOnly && n % 2 == 0) return 0;
+    return mOrder[slot(n)];
+  }
+  [[nodiscard]] uint64_t base() const { return mBase; }
+  [[nodiscard]] uint64_t limit() const { return mLimit; }
+
+private:
+  [[nodiscard]] uint64_t slot(uint64_t n) const { return mOddOnly ? n / 2 : n; }
+  [[nodiscard]] order_t& at(uint64_t n) { return mOrder[slot(n)]; }
+
+  // checked before the table is sized off limit
+  [[nodiscard]] static uint64_t validated(uint64_t base, uint64_t limit)
+  {
+    if (base < 2) throw std::invalid_argument("MultiplicativeOrder: base must be at least 2");
+    if (limit > N) throw std::invalid_argument("MultiplicativeOrder: limit beyond N");
+    return limit;
+  }
+
+  template <typename Sieve> [[nodiscard]] order_t prime_order(uint64_t p, const Sieve& sieve) const;
+  // every value this reads is at most n / 2
+  template <typename Sieve> void fill(uint64_t n, const Sieve& sieve);
+
+  uint64_t mBase;
+  uint64_t mLimit;
+  bool mOddOnly;
+  std::vector<order_t> mOrder;
+};
+
+template <uint64_t N>
+template <typename Sieve>
+MultiplicativeOrder<N>::MultiplicativeOrder(uint64_t base, const Sieve& sieve, uint64_t limit,
+                                            prime::ParallelBuild conf)
+    : mBase(base), mLimit(validated(base, limit)), mOddOnly(base % 2 == 0),
+      mOrder(mOddOnly ? mLimit / 2 + 1 : mLimit + 1)
+{
+  Log(LL::Infra, "constructing orders of $ up to $ on $ threads"_f, base, mLimit, conf.maxThreads);
+
+  if (mLimit >= 1) at(1) = 1;
+
+  const uint64_t serialEnd = std::min(cSegment, mLimit + 1);
+  for (uint64_t n = 2; n < serialEnd; ++n) fill(n, sieve);
+
+  std::vector<uint64_t> chunks;
+  for (uint64_t lo = serialEnd; lo <= mLimit; lo *= 2)
+  {
+    uint64_t hi = std::min(2 * lo, mLimit + 1);
+    chunks.clear();
+    for (uint64_t c = lo; c < hi; c += cSegment) chunks.push_back(c);
+    utils::parallel::foreach (chunks, [&](uint64_t c)
+    {
+      for (uint64_t n = c; n < std::min(c + cSegment, hi); ++n) fill(n, sieve);
+    }, std::max<size_t>(conf.maxThreads, 1));
+  }
+}
+
+template <uint64_t N>
+template <typename Sieve>
+auto MultiplicativeOrder<N>::prime_order(uint64_t p, const Sieve& sieve) const -> order_t
+{
+  const math::ModArith64 arith(p);
+  const uint64_t b = arith.to(mBase), one = arith.one();
+  uint64_t t = p - 1;
+  sieve.for_each_prime_power(p - 1, [&](uint64_t q, uint64_t e)
+  {
+    for (uint64_t i = 0; i < e; ++i) t /= q;
+    for (uint64_t x = arith.pow(b, t); x != one; x = arith.pow(x, q)) t *= q;
+  });
+  return t;
+}
+
+template <uint64_t N>
+template <typename Sieve>
+void MultiplicativeOrder<N>::fill(uint64_t n, const Sieve& sieve)
+{
+  if (mOddOnly && n % 2 == 0) return;
+
+  uint64_t p = sieve.lowest_prime_factor(n);
+  if (p == n)
+  {
+    at(n) = mBase % p == 0 ? 0 : prime_order(p, sieve);
+    return;
+  }
+
+  uint64_t pe = p;
+  while ((n / pe) % p == 0) pe *= p;
+  if (pe != n)
+  {
+    order_t a = (*this)(pe), b = (*this)(n / pe);
+    at(n)     = a == 0 || b == 0 ? 0 : std::lcm(a, b);
+    return;
+  }
+
+  // n = p^k, k >= 2
+  order_t prev = (*this)(n / p);
+  if (prev == 0)
+  {
+    at(n) = 0;
+    return;
+  }
+  at(n) = math::ModArith64(n).pow_mod(mBase, prev) == 1 ? prev : prev * p;
+}
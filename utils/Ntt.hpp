@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <math/Basic.hpp>
+#include <memory>
+#include <stdexcept>
+#include <utils/Fft.hpp>
+#include <utils/ModInt.hpp>
+#include <vector>
+
+/* number theoretic transform
+ * - the fft over ModInt<Mods...> instead of complex<double>: every Mod is an NTT prime c 2^k + 1 and
+ *   each component of the residue vector is transformed with that prime's own roots, so one pass
+ *   covers every modulus
+ * - convolution() picks one, two or three primes from a bound on the coefficients and rebuilds
+ *   them with CRT, exact wherever the true coefficient fits in 64 bits
+ * - sizes up to 2^26, past the 2^23 of 998244353, so 0/1 vectors of 30M+ still fit
+ * - roots and bit reversal come from a cached NttPlan per size, as fft::plan does for complex
+ * */
+namespace ntt {
+
+namespace detail {
+
+// smallest generator of (Z/p)*
+[[nodiscard]] consteval uint32_t primitive_root(uint32_t p)
+{
+  std::array<uint32_t, 10> factors{};
+  size_t count  = 0;
+  uint32_t rest = p - 1;
+  for (uint32_t q = 2; q * q <= rest; ++q)
+    if (rest % q == 0)
+    {
+      factors[count++] = q;
+      while (rest % q == 0) rest /= q;
+    }
+  if (rest > 1) factors[count++] = rest;
+
+  for (uint32_t g = 2;; ++g)
+    if (std::all_of(factors.begin(), factors.begin() + count,
+                    [&](uint32_t q) { return math::pow(uint64_t{g}, (p - 1) / q, uint64_t{p}) != 1; }))
+      return g;
+}
+
+template <uint32_t Mod> inline constexpr uint32_t cRoot = primitive_root(Mod);
+
+} // namespace detail
+
+// 15 2^27 + 1, 7 2^26 + 1, 27 2^26 + 1
+inline constexpr std::array<uint32_t, 3> cPrimes = {2013265921, 469762049, 1811939329};
+
+// largest transform every Mod supports
+template <uint32_t... Mods>
+inline constexpr size_t cMaxSize = std::min({size_t{1} << std::countr_zero(Mods - 1)...});
+
+// the element whose component for each Mod is a primitive order-th root of unity mod that Mod
+template <uint32_t... Mods> [[nodiscard]] ModInt<Mods...> root_of_unity(uint64_t order)
+{
+  ModInt<Mods...> w;
+  size_t i = 0;
+  ((w.mVals[i++] = static_cast<uint32_t>(math::pow(uint64_t{detail::cRoot<Mods>}, (Mods - 1) / order, Mods))),
+   ...);
+  return w;
+}
+
+// roots[len + j] = w_{2 len}^j, laid out like fft::unity_roots
+template <uint32_t... Mods> [[nodiscard]] std::vector<ModInt<Mods...>> unity_roots(size_t n)
+{
+  std::vector<ModInt<Mods...>> roots(std::max<size_t>(n, 2));
+  roots[1] = 1;
+  for (size_t len = 2; len < n; len <<= 1)
+  {
+    const ModInt<Mods...> w = root_of_unity<Mods...>(2 * len);
+    for (size_t j = 0; j < len; j += 2)
+    {
+      roots[len + j]     = roots[(len + j) / 2];
+      roots[len + j + 1] = roots[len + j] * w;
+    }
+  }
+  return roots;
+}
+
+// FftPlan's counterpart: permutation and roots of one size, shared through a per-Mods cache
+template <uint32_t... Mods> class NttPlan
+{
+public:
+  explicit NttPlan(size_t n) : mRoots(unity_roots<Mods...>(n))
+  {
+    if (!std::has_single_bit(n)) throw std::invalid_argument("NttPlan: size is not a power of 2");
+    if (n > cMaxSize<Mods...>) throw std::invalid_argument("NttPlan: size past what the primes support");
+    if (n == 1)
+    {
+      mRev = {0};
+      return;
+    }
+    const auto rev = fft::reverse_bit(n);
+    mRev.assign(rev.begin(), rev.end());
+    mInvN = ModInt<Mods...>(1) / ModInt<Mods...>(static_cast<uint32_t>(n));
+  }
+
+  [[nodiscard]] size_t size() const { return mRev.size(); }
+
+  template <fft::Direction Dir> void execute(std::vector<ModInt<Mods...>>& a) const
+  {
+    const size_t n = size();
+    if (a.size() != n) throw std::invalid_argument("NttPlan: input size doesn't match the plan");
+
+    for (size_t i = 0; i < n; i++)
+      if (i < mRev[i]) std::swap(a[i], a[mRev[i]]);
+
+    for (size_t len = 1; len < n; len <<= 1)
+      for (size_t i = 0; i < n; i += 2 * len)
+        for (size_t j = 0; j < len; j++)
+        {
+          ModInt<Mods...> u = a[i + j];
+          ModInt<Mods...> v = a[i + j + len] * mRoots[len + j];
+          a[i + j]          = u + v;
+          a[i + j + len]    = u - v;
+        }
+
+    if constexpr (Dir == fft::Direction::Inverse)
+    {
+      std::reverse(a.begin() + 1, a.end());
+      for (auto& x : a) x *= mInvN;
+    }
+  }
+
+private:
+  std::vector<uint32_t> mRev;
+  std::vector<ModInt<Mods...>> mRoots;
+  ModInt<Mods...> mInvN = 1;
+};
+
+template <uint32_t... Mods> [[nodiscard]] std::shared_ptr<const NttPlan<Mods...>> plan(size_t n)
+{
+  static fft::detail::PlanCache<NttPlan<Mods...>> cache;
+  if (!std::has_single_bit(n)) throw std::invalid_argument("ntt::plan: size is not a power of 2");
+  return cache.get(n);
+}
+
+template <fft::Direction Dir, uint32_t... Mods> void transform(std::vector<ModInt<Mods...>>& a)
+{
+  if (!std::has_single_bit(a.size())) throw std::invalid_argument("ntt::transform: size is not a power of 2");
+  plan<Mods...>(a.size())->template execute<Dir>(a);
+}
+
+// the integer below the product of Mods with these residues, taken mod 2^64 (Garner)
+template <uint32_t... Mods> [[nodiscard]] uint64_t reconstruct(const ModInt<Mods...>& x)
+{
+  constexpr size_t K = sizeof...(Mods);
+  static constexpr std::array<uint64_t, K> mods{Mods...};
+  // prefix[i][j] = m_0 ... m_(j-1) mod m_i and inv[i] = 1 / prefix[i][i]
+  struct Tables
+  {
+    std::array<std::array<uint64_t, K + 1>, K> prefix{};
+    std::array<uint64_t, K> inv{};
+  };
+  static constexpr Tables t = []
+  {
+    Tables tables;
+    for (size_t i = 0; i < K; ++i)
+    {
+      tables.prefix[i][0] = 1;
+      for (size_t j = 0; j < i; ++j) tables.prefix[i][j + 1] = tables.prefix[i][j] * mods[j] % mods[i];
+      tables.inv[i] = math::pow(tables.prefix[i][i], mods[i] - 2, mods[i]);
+    }
+    return tables;
+  }();
+
+  std::array<uint64_t, K> digits{};
+  unsigned __int128 value = 0, scale = 1;
+  for (size_t i = 0; i < K; ++i)
+  {
+    const uint64_t m  = mods[i];
+    uint64_t valueMod = 0;
+    for (size_t j = 0; j < i; ++j) valueMod = (valueMod + digits[j] * t.prefix[i][j]) % m;
+    digits[i] = (x.mVals[i] + m - valueMod) % m * t.inv[i] % m;
+    value += scale * digits[i];
+    scale *= m;
+  }
+  return static_cast<uint64_t>(value);
+}
+
+namespace detail {
+
+template <uint32_t... Mods, typename T>
+[[nodiscard]] std::vector<uint64_t> convolve(const std::vector<T>& a, const std::vector<T>& b, bool self)
+{
+  const size_t size = a.size() + b.size() - 1;
+  const size_t n    = std::bit_ceil(size);
+
+  const auto lift = [n](const std::vector<T>& v)
+  {
+    std::vector<ModInt<Mods...>> f(n);
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+      size_t k = 0;
+      ((f[i].mVals[k++] = static_cast<uint32_t>(static_cast<uint64_t>(v[i]) % Mods)), ...);
+    }
+    return f;
+  };
+
+  const auto p                    = plan<Mods...>(n);
+  std::vector<ModInt<Mods...>> fa = lift(a);
+  p->template execute<fft::Direction::Forward>(fa);
+  if (self)
+    for (auto& x : fa) x *= x;
+  else
+  {
+    std::vector<ModInt<Mods...>> fb = lift(b);
+    p->template execute<fft::Direction::Forward>(fb);
+    for (size_t i = 0; i < n; i++) fa[i] *= fb[i];
+  }
+  p->template execute<fft::Direction::Inverse>(fa);
+
+  std::vector<uint64_t> result(size);
+  for (size_t i = 0; i < size; ++i) result[i] = reconstruct(fa[i]);
+  return result;
+}
+
+template <typename T>
+[[nodiscard]] std::vector<uint64_t> convolve_exact(const std::vector<T>& a, const std::vector<T>& b,
+                                                   bool self)
+{
+  if (a.empty() || b.empty()) return {};
+  const auto largest = [](const std::vector<T>& v)
+  {
+    if constexpr (std::is_signed_v<T>)
+      if (std::ranges::any_of(v, [](T x) { return x < 0; }))
+        throw std::invalid_argument("ntt::convolution: coefficients must be non-negative");
+    return static_cast<unsigned __int128>(std::ranges::max(v));
+  };
+
+  // no output coefficient exceeds product * overlap, so that decides how many primes the CRT needs
+  const unsigned __int128 product = largest(a) * largest(b);
+  const unsigned __int128 overlap = std::min(a.size(), b.size());
+  const auto below                = [&](unsigned __int128 m) { return product <= (m - 1) / overlap; };
+  constexpr auto p                = cPrimes;
+  if (below(p[0])) return convolve<p[0]>(a, b, self);
+  if (below(static_cast<unsigned __int128>(p[0]) * p[1])) return convolve<p[0], p[1]>(a, b, self);
+  return convolve<p[0], p[1], p[2]>(a, b, self);
+}
+
+} // namespace detail
+
+// exact counterpart of fft::convolution for non-negative integers, no rounding step
+template <std::integral T>
+[[nodiscard]] std::vector<uint64_t> convolution(const std::vector<T>& a, const std::vector<T>& b)
+{
+  return detail::convolve_exact(a, b, false);
+}
+
+template <std::integral T> [[nodiscard]] std::vector<uint64_t> self_convolution(const std::vector<T>& a)
+{
+  return detail::convolve_exact(a, a, true);
+}
+
+} // namespace ntt
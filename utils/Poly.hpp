@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <utils/ModInt.hpp>
+#include <utils/Ntt.hpp>
+#include <vector>
+
+/* Poly
+ * - polynomials and truncated power series over ModInt<Mods...> with every Mod an NTT prime, so
+ *   ModInt<ntt::cPrimes[0]> works as well as the usual 998244353; products go through ntt plans
+ * - inverse, sqrt, log and exp to n terms by Newton iteration, a fixed number of products per doubling
+ *   of the precision: O(n log n)
+ * - division with remainder through the inverse of the reversed divisor, evaluation at m points
+ *   through a subproduct tree of the points: O(n log^2 n)
+ * - coefficients past size() read as zero; size() is whatever the last operation produced, trailing
+ *   zeros included, except where a degree is asked for
+ * */
+template <typename M> class Poly;
+
+template <uint32_t... Mods> class Poly<ModInt<Mods...>>
+{
+public:
+  using M = ModInt<Mods...>;
+
+  // below this many coefficients on the shorter side schoolbook beats three transforms
+  static constexpr size_t cNaiveMax = 32;
+  // subproduct tree ranges this small are evaluated point by point
+  static constexpr size_t cLeafPoints = 64;
+
+  Poly() = default;
+  Poly(std::vector<M> coeffs) : mCoeffs(std::move(coeffs)) {}
+  Poly(std::initializer_list<M> coeffs) : mCoeffs(coeffs) {}
+
+  [[nodiscard]] size_t size() const { return mCoeffs.size(); }
+  [[nodiscard]] const std::vector<M>& coeffs() const { return mCoeffs; }
+
+  // -1 for the zero polynomial
+  [[nodiscard]] int64_t degree() const
+  {
+    for (size_t i = size(); i-- > 0;)
+      if (!(mCoeffs[i] == M(0))) return static_cast<int64_t>(i);
+    return -1;
+  }
+
+  [[nodiscard]] M operator[](size_t i) const { return i < size() ? mCoeffs[i] : M(0); }
+  [[nodiscard]] M& operator[](size_t i)
+  {
+    assert(i < size() && "coefficient past the stored ones");
+    return mCoeffs[i];
+  }
+
+  // this mod x^n, padded with zeros up to n
+  [[nodiscard]] Poly truncated(size_t n) const
+  {
+    std::vector<M> c(n);
+    std::copy_n(mCoeffs.begin(), std::min(n, size()), c.begin());
+    return Poly(std::move(c));
+  }
+
+  Poly& trim()
+  {
+    mCoeffs.resize(static_cast<size_t>(degree() + 1));
+    return *this;
+  }
+
+  [[nodiscard]] bool operator==(const Poly& other) const
+  {
+    for (size_t i = 0; i < std::max(size(), other.size()); ++i)
+      if (!((*this)[i] == other[i])) return false;
+    return true;
+  }
+
+  Poly& operator+=(const Poly& other)
+  {
+    if (other.size() > size()) mCoeffs.resize(other.size());
+    for (size_t i = 0; i < other.size(); ++i) mCoeffs[i] += other.mCoeffs[i];
+    return *this;
+  }
+
+  Poly& operator-=(const Poly& other)
+  {
+    if (other.size() > size()) mCoeffs.resize(other.size());
+    for (size_t i = 0; i < other.size(); ++i) mCoeffs[i] -= other.mCoeffs[i];
+    return *this;
+  }
+
+  Poly& operator*=(const M& k)
+  {
+    for (M& c : mCoeffs) c *= k;
+    return *this;
+  }
+
+  Poly& operator*=(const Poly& other)
+  {
+    mCoeffs = multiply(mCoeffs, other.mCoeffs);
+    return *this;
+  }
+
+  [[nodiscard]] friend Poly operator+(Poly a, const Poly& b) { return a += b; }
+  [[nodiscard]] friend Poly operator-(Poly a, const Poly& b) { return a -= b; }
+  [[nodiscard]] friend Poly operator*(Poly a, const M& k) { return a *= k; }
+  [[nodiscard]] friend Poly operator*(const Poly& a, const Poly& b)
+  {
+    return Poly(multiply(a.mCoeffs, b.mCoeffs));
+  }
+
+  [[nodiscard]] Poly derivative() const
+  {
+    if (size() <= 1) return {};
+    std::vector<M> c(size() - 1);
+    for (size_t i = 1; i < size(); ++i) c[i - 1] = mCoeffs[i] * M(static_cast<uint32_t>(i));
+    return Poly(std::move(c));
+  }
+
+  // the antiderivative with constant term 0
+  [[nodiscard]] Poly integral() const
+  {
+    const auto inv = inverses(size());
+    std::vector<M> c(size() + 1);
+    for (size_t i = 0; i < size(); ++i) c[i + 1] = mCoeffs[i] * inv[i + 1];
+    return Poly(std::move(c));
+  }
+
+  // 1 / this mod x^n: g <- g (2 - f g)
+  [[nodiscard]] Poly inverse(size_t n) const
+  {
+    if (!invertible((*this)[0])) throw std::invalid_argument("Poly::inverse: constant term not invertible");
+    Poly g{M(1) / (*this)[0]};
+    for (size_t m = 2; m / 2 < n; m *= 2)
+    {
+      Poly fg = (truncated(m) * g).truncated(m);
+      for (M& c : fg.mCoeffs) c = -c;
+      fg.mCoeffs[0] += M(2);
+      g = (g * fg).truncated(m);
+    }
+    return g.truncated(n);
+  }
+
+  // the square root with constant term 1 of a series with constant term 1: g <- (g + f / g) / 2
+  [[nodiscard]] Poly sqrt(size_t n) const
+  {
+    if (!((*this)[0] == M(1))) throw std::invalid_argument("Poly::sqrt: constant term must be 1");
+    const M half = M(1) / M(2);
+    Poly g{M(1)};
+    for (size_t m = 2; m / 2 < n; m *= 2) g = ((g + truncated(m) * g.inverse(m)) * half).truncated(m);
+    return g.truncated(n);
+  }
+
+  // log f = integral(f' / f), for constant term 1
+  [[nodiscard]] Poly log(size_t n) const
+  {
+    if (!((*this)[0] == M(1))) throw std::invalid_argument("Poly::log: constant term must be 1");
+    if (n == 0) return {};
+    return (truncated(n).derivative() * inverse(n)).truncated(n - 1).integral();
+  }
+
+  // exp f for constant term 0: g <- g (1 - log g + f)
+  [[nodiscard]] Poly exp(size_t n) const
+  {
+    if (!((*this)[0] == M(0))) throw std::invalid_argument("Poly::exp: constant term must be 0");
+    Poly g{M(1)};
+    for (size_t m = 2; m / 2 < n; m *= 2)
+    {
+      Poly step = truncated(m) - g.log(m);
+      step.mCoeffs[0] += M(1);
+      g = (g * step).truncated(m);
+    }
+    return g.truncated(n);
+  }
+
+  // quotient and remainder, the remainder of degree below d's; d's leading coefficient must be invertible
+  [[nodiscard]] std::pair<Poly, Poly> divmod(const Poly& d) const
+  {
+    const int64_t da = degree(), dd = d.degree();
+    if (dd < 0) throw std::invalid_argument("Poly::divmod: division by the zero polynomial");
+    if (da < dd) return {Poly{}, truncated(static_cast<size_t>(da + 1))};
+
+    const size_t k = static_cast<size_t>(da - dd + 1);
+    if (dd <= static_cast<int64_t>(cNaiveMax) || k <= cNaiveMax) return long_division(d);
+
+    const auto reversed = [](const Poly& p, int64_t deg)
+    {
+      std::vector<M> c(p.mCoeffs.begin(), p.mCoeffs.begin() + deg + 1);
+      std::ranges::reverse(c);
+      return Poly(std::move(c));
+    };
+    Poly q = (reversed(*this, da).truncated(k) * reversed(d, dd).inverse(k)).truncated(k);
+    std::ranges::reverse(q.mCoeffs);
+    Poly r = (*this - d * q).truncated(static_cast<size_t>(dd));
+    return {std::move(q), std::move(r)};
+  }
+
+  [[nodiscard]] friend Poly operator/(const Poly& a, const Poly& b) { return a.divmod(b).first; }
+  [[nodiscard]] friend Poly operator%(const Poly& a, const Poly& b) { return a.divmod(b).second; }
+
+  [[nodiscard]] M operator()(const M& x) const
+  {
+    M y = 0;
+    for (size_t i = size(); i-- > 0;) y = y * x + mCoeffs[i];
+    return y;
+  }
+
+  // this at every point: the remainder mod the product of (x - p) over a range of points keeps the values
+  // on that range, so remainders are passed down a product tree built bottom up
+  [[nodiscard]] std::vector<M> evaluate(const std::vector<M>& points) const
+  {
+    std::vector<M> values(points.size());
+    if (points.empty()) return values;
+    std::vector<Poly> tree(4 * (points.size() / cLeafPoints + 1));
+    build_tree(tree, points, 1, 0, points.size());
+    evaluate_down(tree, points, values, 1, 0, points.size(), *this);
+    return values;
+  }
+
+private:
+  [[nodiscard]] static bool invertible(const M& x)
+  {
+    return std::ranges::none_of(x.mVals, [](uint32_t v) { return v == 0; });
+  }
+
+  // 1 / i for i <= n, componentwise by inv(i) = -(p / i) inv(p % i) mod p
+  [[nodiscard]] static std::vector<M> inverses(size_t n)
+  {
+    std::vector<M> inv(n + 1);
+    size_t k = 0;
+    (
+        [&](uint32_t p)
+        {
+          if (n >= 1) inv[1].mVals[k] = 1;
+          for (size_t i = 2; i <= n; ++i)
+            inv[i].mVals[k] = static_cast<uint32_t>((p - uint64_t{p / i}) * inv[p % i].mVals[k] % p);
+          ++k;
+        }(Mods),
+        ...);
+    return inv;
+  }
+
+  [[nodiscard]] static std::vector<M> multiply(const std::vector<M>& a, const std::vector<M>& b)
+  {
+    if (a.empty() || b.empty()) return {};
+    const size_t size = a.size() + b.size() - 1;
+    if (std::min(a.size(), b.size()) <= cNaiveMax)
+    {
+      std::vector<M> c(size);
+      for (size_t i = 0; i < a.size(); ++i)
+        for (size_t j = 0; j < b.size(); ++j) c[i + j] += a[i] * b[j];
+      return c;
+    }
+
+    const size_t n = std::bit_ceil(size);
+    const auto p   = ntt::plan<Mods...>(n);
+    std::vector<M> fa(a), fb(b);
+    fa.resize(n);
+    fb.resize(n);
+    p->template execute<fft::Direction::Forward>(fa);
+    p->template execute<fft::Direction::Forward>(fb);
+    for (size_t i = 0; i < n; ++i) fa[i] *= fb[i];
+    p->template execute<fft::Direction::Inverse>(fa);
+    fa.resize(size);
+    return fa;
+  }
+
+  // schoolbook division for short quotients or divisors
+  [[nodiscard]] std::pair<Poly, Poly> long_division(const Poly& d) const
+  {
+    const int64_t da = degree(), dd = d.degree();
+    std::vector<M> r(mCoeffs.begin(), mCoeffs.begin() + da + 1), q(static_cast<size_t>(da - dd + 1));
+    const M lead = M(1) / d.mCoeffs[dd];
+    for (int64_t i = da - dd; i >= 0; --i)
+    {
+      const M c = r[i + dd] * lead;
+      q[i]      = c;
+      for (int64_t j = 0; j <= dd; ++j) r[i + j] -= c * d.mCoeffs[j];
+    }
+    r.resize(static_cast<size_t>(dd));
+    return {Poly(std::move(q)), Poly(std::move(r))};
+  }
+
+  static void build_tree(std::vector<Poly>& tree, const std::vector<M>& points, size_t node, size_t lo,
+                         size_t hi)
+  {
+    if (hi - lo <= cLeafPoints)
+    {
+      Poly p{M(1)};
+      for (size_t i = lo; i < hi; ++i) p *= Poly{-points[i], M(1)};
+      tree[node] = std::move(p);
+      return;
+    }
+    const size_t mid = (lo + hi) / 2;
+    build_tree(tree, points, 2 * node, lo, mid);
+    build_tree(tree, points, 2 * node + 1, mid, hi);
+    tree[node] = tree[2 * node] * tree[2 * node + 1];
+  }
+
+  static void evaluate_down(const std::vector<Poly>& tree, const std::vector<M>& points,
+                            std::vector<M>& values, size_t node, size_t lo, size_t hi, const Poly& f)
+  {
+    const Poly r = f % tree[node];
+    if (hi - lo <= cLeafPoints)
+    {
+      for (size_t i = lo; i < hi; ++i) values[i] = r(points[i]);
+      return;
+    }
+    const size_t mid = (lo + hi) / 2;
+    evaluate_down(tree, points, values, 2 * node, lo, mid, r);
+    evaluate_down(tree, points, values, 2 * node + 1, mid, hi, r);
+  }
+
+  std::vector<M> mCoeffs;
+};
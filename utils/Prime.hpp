@@ -1,53 +1,397 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <map>
 #include <math/Basic.hpp>
+#include <math/ModArith.hpp>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <utils/Hash.hpp>
 #include <utils/Logging.hpp>
+#include <utils/MappedFile.hpp>
+#include <utils/maya/Prime.hpp>
+#include <utils/Parallel.hpp>
 #include <vector>
 
 namespace prime::detail {
 
-struct Wheel6
+// floor(sqrt(n)), exact for the whole uint64 range
+[[nodiscard]] inline uint64_t isqrt(uint64_t n)
 {
-  explicit Wheel6(uint64_t start)
+  uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+  while (r > 0 && r > n / r) --r;
+  while ((r + 1) <= n / (r + 1)) ++r;
+  return r;
+}
+
+// plain Eratosthenes, used to seed the segmented engines with their base primes
+[[nodiscard]] inline std::vector<uint64_t> primes_upto(uint64_t limit)
+{
+  std::vector<uint64_t> primes;
+  if (limit < 2) return primes;
+  std::vector<char> composite(limit + 1, 0);
+  for (uint64_t i = 2; i <= limit; ++i)
+  {
+    if (composite[i]) continue;
+    primes.push_back(i);
+    for (uint64_t j = i * i; j <= limit; j += i) composite[j] = 1;
+  }
+  return primes;
+}
+
+} // namespace prime::detail
+
+namespace prime {
+
+// deterministic for every 64-bit n
+[[nodiscard]] inline bool miller_rabin(uint64_t n)
+{
+  if (n < 2) return false;
+  for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+    if (n % p == 0) return n == p;
+  if (n < 37 * 37) return true;
+
+  static constexpr uint64_t bases32[] = {2, 7, 61};
+  static constexpr uint64_t bases64[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+  math::Montgomery64 mont(n);
+  const uint64_t one      = mont.to(1);
+  const uint64_t minusOne = mont.to(n - 1);
+  const int s             = __builtin_ctzll(n - 1);
+  const uint64_t d        = (n - 1) >> s;
+
+  const auto witness = [&](uint64_t a)
+  {
+    if (a % n == 0) return false;
+    uint64_t x = mont.pow(mont.to(a), d);
+    if (x == one || x == minusOne) return false;
+    for (int i = 1; i < s; ++i)
+    {
+      x = mont.mul(x, x);
+      if (x == minusOne) return false;
+    }
+    return true;
+  };
+
+  if (n < (uint64_t{1} << 32)) return std::ranges::none_of(bases32, witness);
+  return std::ranges::none_of(bases64, witness);
+}
+
+// returns a non-trivial divisor of an odd composite n
+[[nodiscard]] inline uint64_t pollard_brent(uint64_t n)
+{
+  constexpr uint64_t batch = 128; // steps between gcds
+  math::Montgomery64 mont(n);
+  const auto dist = [](uint64_t a, uint64_t b) { return a > b ? a - b : b - a; };
+
+  for (uint64_t c = 1;; ++c)
   {
-    uint64_t next = start;
-    while (next % 6 != 1 && next % 6 != 5) ++next;
-    mFirst = next - start;
-    mStep  = (next % 6 == 5) ? 2 : 4;
+    const uint64_t cm = mont.to(c);
+    const auto f      = [&](uint64_t x) { return mont.add(mont.mul(x, x), cm); };
+
+    uint64_t x = 0, y = mont.to(2), ys = y, q = mont.to(1), g = 1;
+    for (uint64_t r = 1; g == 1; r <<= 1)
+    {
+      x = y;
+      for (uint64_t i = 0; i < r; ++i) y = f(y);
+      for (uint64_t k = 0; k < r && g == 1; k += batch)
+      {
+        ys = y;
+        for (uint64_t i = 0; i < std::min(batch, r - k); ++i)
+        {
+          y = f(y);
+          q = mont.mul(q, dist(x, y));
+        }
+        g = std::gcd(q, n);
+      }
+    }
+
+    // the batch overshot, replay it one step at a time
+    if (g == n)
+      do
+      {
+        ys = f(ys);
+        g  = std::gcd(dist(x, ys), n);
+      } while (g == 1);
+
+    if (g != n) return g;
   }
+}
+
+} // namespace prime
+
+namespace prime::detail {
 
-  uint64_t advance()
+// entries owned in memory, or a read-only view into a mapped sieve cache
+template <typename T> class Table
+{
+public:
+  explicit Table(size_t n, T fill = T{}) : mOwned(n, fill), mData(mOwned.data()) {}
+  explicit Table(const T* mapped) : mData(mapped) {}
+
+  Table(const Table& o) : mOwned(o.mOwned), mData(o.owned() ? mOwned.data() : o.mData) {}
+  Table(Table&& o) noexcept : mOwned(std::move(o.mOwned)), mData(o.mData) {}
+  Table& operator=(Table o) noexcept
   {
-    if (mFirst != 0) return std::exchange(mFirst, 0);
-    return std::exchange(mStep, 6 - mStep);
+    mOwned.swap(o.mOwned);
+    std::swap(mData, o.mData);
+    return *this;
   }
 
+  [[nodiscard]] T operator[](size_t i) const { return mData[i]; }
+  [[nodiscard]] T& mut(size_t i) { return mOwned[i]; } // only while building, never on a view
+  [[nodiscard]] const T* data() const { return mData; }
+  [[nodiscard]] bool owned() const { return !mOwned.empty(); }
+
 private:
-  uint64_t mFirst;
-  uint64_t mStep;
+  std::vector<T> mOwned;
+  const T* mData;
 };
 
 } // namespace prime::detail
 
-template <uint64_t N> class PrimeSieve
+/* lowest-prime-factor tables for PrimeSieve
+ * - Wide keeps one prime_t per index, lpf(i) == i marks a prime
+ * - Compact keeps odd indices only and stores the lpf in the narrowest type that fits sqrt(N),
+ *   0 marks a prime (or 1). Evens are answered as 2 without a lookup. 8x smaller for N < 2^32
+ * - both can be built in memory or view cEntries entries of a mapped cache file
+ * */
+namespace prime::storage {
+
+template <uint64_t N> struct Wide
 {
-  static_assert(N > 2);
+  using entry_t = uint64_t;
+
+  static constexpr std::string_view cName = "wide";
+  static constexpr bool cOddOnly          = false;
+  static constexpr uint64_t cBlockSpan    = uint64_t{1} << 15; // 256KB of table per parallel block
+  static constexpr uint64_t cEntries      = N + 1;
+
+  Wide() : mLpf(cEntries)
+  {
+    for (uint64_t i = 0; i <= N; ++i) mLpf.mut(i) = i;
+  }
+  explicit Wide(const entry_t* mapped) : mLpf(mapped) {}
+
+  [[nodiscard]] bool is_composite(uint64_t n) const { return mLpf[n] != n; }
+  [[nodiscard]] uint64_t lowest(uint64_t n) const { return mLpf[n]; }
+  void mark(uint64_t n, uint64_t p)
+  {
+    if (mLpf[n] == n) mLpf.mut(n) = p;
+  }
+  [[nodiscard]] const entry_t* data() const { return mLpf.data(); }
+
+private:
+  prime::detail::Table<entry_t> mLpf;
+};
+
+template <uint64_t N> struct Compact
+{
+  using entry_t = std::conditional_t<(N < (uint64_t{1} << 32)), uint16_t, uint32_t>;
+
+  static constexpr std::string_view cName = "compact";
+  static constexpr bool cOddOnly          = true;
+  static constexpr uint64_t cBlockSpan    = uint64_t{1} << 18;
+  static constexpr uint64_t cEntries      = N / 2 + 1;
+
+  Compact() : mLpf(cEntries, 0) {}
+  explicit Compact(const entry_t* mapped) : mLpf(mapped) {}
+
+  [[nodiscard]] bool is_composite(uint64_t n) const { return n % 2 == 0 ? n > 2 : mLpf[n / 2] != 0; }
+  [[nodiscard]] uint64_t lowest(uint64_t n) const
+  {
+    if (n % 2 == 0) return n == 0 ? 0 : 2;
+    entry_t p = mLpf[n / 2];
+    return p == 0 ? n : p;
+  }
+  // only odd n reach here, the sieve skips even multiples
+  void mark(uint64_t n, uint64_t p)
+  {
+    if (mLpf[n / 2] == 0) mLpf.mut(n / 2) = static_cast<entry_t>(p);
+  }
+  [[nodiscard]] const entry_t* data() const { return mLpf.data(); }
+
+private:
+  prime::detail::Table<entry_t> mLpf;
+};
+
+} // namespace prime::storage
+
+namespace prime {
+
+// pass to PrimeSieve's constructor to sieve cache-sized blocks concurrently
+struct ParallelBuild
+{
+  size_t maxThreads = std::thread::hardware_concurrency();
+};
+
+// pass to PrimeSieve's constructor to map the sieve from dir, building and writing it there on a miss.
+// The file is written to a temp name and renamed, so concurrent first runs never see a torn file
+struct CacheFile
+{
+  std::filesystem::path dir = std::filesystem::temp_directory_path();
+  bool verify               = true; // checksum the mapped payload before trusting it
+};
+
+namespace detail {
+
+struct CacheHeader
+{
+  static constexpr uint64_t cMagic   = 0x5645495345494f45; // "OEISIEVE"
+  static constexpr uint32_t cVersion = 1;
+
+  uint64_t magic;
+  uint32_t version;
+  uint32_t entryBytes;
+  uint64_t n;
+  uint64_t entries;
+  uint64_t primeCount;
+  uint64_t checksum; // of everything after the header
+  uint64_t reserved[2];
+};
+static_assert(sizeof(CacheHeader) == 64);
+
+} // namespace detail
 
+} // namespace prime
+
+/* SmallFactorList
+ * - (prime, exp) pairs sorted by prime, kept inline so factoring in a hot loop never allocates
+ * - 15 slots: the product of the first 16 primes already overflows uint64
+ * */
+class SmallFactorList
+{
 public:
-  using prime_t = uint64_t;
-  using exp_t   = uint64_t;
+  using value_type = std::pair<uint64_t, uint64_t>;
 
-  PrimeSieve();
+  static constexpr size_t cCapacity = 15;
 
-  [[nodiscard]] bool is_prime(uint64_t n) const;
+  // primes must arrive in non-decreasing order, as emit_factors hands them out
+  void push(uint64_t p)
+  {
+    if (mSize > 0 && mData[mSize - 1].first == p)
+      ++mData[mSize - 1].second;
+    else
+      mData[mSize++] = {p, 1};
+  }
+
+  [[nodiscard]] size_t size() const { return mSize; }
+  [[nodiscard]] bool empty() const { return mSize == 0; }
+  [[nodiscard]] const value_type& operator[](size_t i) const { return mData[i]; }
+  [[nodiscard]] const value_type& back() const { return mData[mSize - 1]; }
+  [[nodiscard]] const value_type* begin() const { return mData.data(); }
+  [[nodiscard]] const value_type* end() const { return mData.data() + mSize; }
+
+private:
+  std::array<value_type, cCapacity> mData;
+  uint8_t mSize = 0;
+};
+
+namespace prime::detail {
+
+// is_prime for n past a sieve's bound: trial division by its primes up to trialBound, then Miller-Rabin
+[[nodiscard]] bool is_prime_above(uint64_t n, const auto& primes, uint64_t trialBound)
+{
+  for (uint64_t p : primes)
+  {
+    if (p > trialBound) break;
+    if (p * p > n) return true;
+    if (n % p == 0) return false;
+  }
+  return prime::miller_rabin(n);
+}
+
+// factoring for n past a sieve's bound. lowest(m) gives the lowest prime factor of 1 < m <= limit;
+// trial division by primes up to trialBound, then the rest split with Pollard-Brent and handed out sorted
+void emit_factors_above(uint64_t n, uint64_t limit, const auto& primes, uint64_t trialBound, auto lowest,
+                        auto callback)
+{
+  const auto fastFactor = [&](uint64_t m)
+  {
+    while (m != 1)
+    {
+      uint64_t p = lowest(m);
+      callback(p);
+      m /= p;
+    }
+  };
+
+  for (uint64_t p : primes)
+  {
+    if (p > trialBound) break;
+    if (p * p > n)
+    {
+      callback(n);
+      return;
+    }
+    while (n % p == 0)
+    {
+      callback(p);
+      n /= p;
+      if (n <= limit) return fastFactor(n);
+    }
+  }
+
+  // a 64-bit n has at most 63 prime factors
+  std::array<uint64_t, 64> found{};
+  size_t count = 0;
+
+  const auto split = [&](auto& self, uint64_t m) -> void
+  {
+    if (m <= limit)
+    {
+      while (m != 1)
+      {
+        uint64_t p     = lowest(m);
+        found[count++] = p;
+        m /= p;
+      }
+      return;
+    }
+    if (prime::miller_rabin(m))
+    {
+      found[count++] = m;
+      return;
+    }
+    uint64_t d = prime::pollard_brent(m);
+    self(self, d);
+    self(self, m / d);
+  };
+
+  split(split, n);
+  std::sort(found.begin(), found.begin() + count);
+  for (size_t i = 0; i < count; ++i) callback(found[i]);
+}
+
+// the factor APIs every sieve offers, all driven by Derived::emit_factors
+template <typename Derived> class FactorQueries
+{
+public:
+  using prime_t = uint64_t;
+  using exp_t   = uint64_t;
 
   [[nodiscard]] std::vector<prime_t> distinct_factors(uint64_t n) const
   {
     std::vector<prime_t> result;
-    emit_factors(n, [&](prime_t p)
+    self().emit_factors(n, [&](prime_t p)
     {
       if (result.empty() || p != result.back()) result.push_back(p);
     });
@@ -57,14 +401,14 @@ public:
   [[nodiscard]] std::vector<prime_t> factors(uint64_t n) const
   {
     std::vector<prime_t> result;
-    emit_factors(n, [&](prime_t p) { result.push_back(p); });
+    self().emit_factors(n, [&](prime_t p) { result.push_back(p); });
     return result;
   }
 
   [[nodiscard]] std::map<prime_t, exp_t> factors_freq(uint64_t n) const
   {
     std::map<prime_t, exp_t> freq;
-    emit_factors(n, [&](prime_t p) { ++freq[p]; });
+    self().emit_factors(n, [&](prime_t p) { ++freq[p]; });
     return freq;
   }
 
@@ -72,7 +416,7 @@ public:
   [[nodiscard]] std::vector<std::pair<prime_t, exp_t>> vector_factors_freq(uint64_t n) const
   {
     std::vector<std::pair<prime_t, exp_t>> freq;
-    emit_factors(n, [&](prime_t p)
+    self().emit_factors(n, [&](prime_t p)
     {
       if (freq.empty() || freq.back().first != p)
         freq.emplace_back(p, 1);
@@ -82,99 +426,1215 @@ public:
     return freq;
   }
 
-  [[nodiscard]] const std::vector<prime_t>& all_primes() const { return mAllPrimes; };
-  [[nodiscard]] prime_t lowest_prime_factor(uint64_t n) const { return mLowestPrimeDiv[n]; }
+  // same as vector_factors_freq, without touching the heap
+  [[nodiscard]] SmallFactorList small_factors_freq(uint64_t n) const
+  {
+    SmallFactorList freq;
+    self().emit_factors(n, [&](prime_t p) { freq.push(p); });
+    return freq;
+  }
+
+  // callback(p, e) once per distinct prime, in increasing order
+  void for_each_prime_power(uint64_t n, auto callback) const
+  {
+    prime_t last = 0;
+    exp_t e      = 0;
+    self().emit_factors(n, [&](prime_t p)
+    {
+      if (p != last && e > 0) callback(last, e);
+      e    = p == last ? e + 1 : 1;
+      last = p;
+    });
+    if (e > 0) callback(last, e);
+  }
+
+  // 1 for n = 1, like FactorWindow
   [[nodiscard]] prime_t highest_prime_factor(uint64_t n) const
   {
-    uint64_t result;
-    emit_factors(n, [&](prime_t p) { result = p; });
+    prime_t result = 1;
+    self().emit_factors(n, [&](prime_t p) { result = p; });
     return result;
   }
 
 private:
-  // callback will be called in sorted order (small to large primes)
+  [[nodiscard]] const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+} // namespace prime::detail
+
+template <uint64_t N, template <uint64_t> typename Storage = prime::storage::Wide>
+class PrimeSieve : public prime::detail::FactorQueries<PrimeSieve<N, Storage>>
+{
+  static_assert(N > 2);
+
+public:
+  using prime_t = uint64_t;
+  using exp_t   = uint64_t;
+
+  // trial division only pays for the smallest primes; past this is_prime and factoring
+  // above N switch to Miller-Rabin and Pollard-Brent
+  static constexpr prime_t cTrialBound = 1 << 9;
+
+  PrimeSieve();
+  explicit PrimeSieve(prime::ParallelBuild conf);
+  explicit PrimeSieve(prime::CacheFile conf);
+
+  [[nodiscard]] bool is_prime(uint64_t n) const;
+
+  [[nodiscard]] const std::vector<prime_t>& all_primes() const { return mAllPrimes; };
+  [[nodiscard]] prime_t lowest_prime_factor(uint64_t n) const { return mLowestPrimeDiv.lowest(n); }
+  // callback(p) once per prime factor with multiplicity, in sorted order (small to large primes).
+  // the building block of every FactorQueries API, use it directly to factor without allocating
   void emit_factors(uint64_t /*n*/, auto /*callback*/) const;
 
-  std::vector<prime_t> mLowestPrimeDiv = std::vector<prime_t>(N + 1); // lowest prime divisor of i
+private:
+  void build_blocks(size_t maxThreads);
+  // sieves [lo, hi) of the table with every base prime and appends the primes found to out
+  void sieve_block(uint64_t lo, uint64_t hi, const std::vector<prime_t>& basePrimes,
+                   std::vector<prime_t>& out);
+
+  // cache layout: header | table entries, padded to 8 bytes | all primes
+  using entry_t                         = typename Storage<N>::entry_t;
+  static constexpr size_t cTableBytes   = Storage<N>::cEntries * sizeof(entry_t);
+  static constexpr size_t cTableOffset  = sizeof(prime::detail::CacheHeader);
+  static constexpr size_t cPrimesOffset = cTableOffset + (cTableBytes + 7) / 8 * 8;
+  [[nodiscard]] static std::filesystem::path cache_path(const prime::CacheFile& conf);
+  [[nodiscard]] static std::shared_ptr<const utils::MappedFile> load_cache(const prime::CacheFile& conf);
+  void write_cache(const prime::CacheFile& conf) const;
+
+  std::shared_ptr<const utils::MappedFile> mMapping; // set when the table views a cache file
+  Storage<N> mLowestPrimeDiv;                        // lowest prime divisor of i
   std::vector<prime_t> mAllPrimes;
 };
 
-template <uint64_t N> PrimeSieve<N>::PrimeSieve()
+template <uint64_t N> using CompactPrimeSieve = PrimeSieve<N, prime::storage::Compact>;
+
+template <uint64_t N, template <uint64_t> typename Storage> PrimeSieve<N, Storage>::PrimeSieve()
 {
   Log(LL::Infra, "constructing a prime helper with N=$", N);
 
   mAllPrimes.reserve(N / std::log(N));
 
-  for (uint64_t i = 0; i <= N; ++i) mLowestPrimeDiv[i] = i;
-
-  for (uint64_t i = 2; i * i <= N; ++i)
-    if (mLowestPrimeDiv[i] == i)
-      for (uint64_t j = i * i; j <= N; j += i)
-        if (mLowestPrimeDiv[j] == j) mLowestPrimeDiv[j] = i;
+  constexpr bool oddOnly = Storage<N>::cOddOnly;
+  for (uint64_t i = oddOnly ? 3 : 2; i * i <= N; i += oddOnly ? 2 : 1)
+    if (!mLowestPrimeDiv.is_composite(i))
+      for (uint64_t j = i * i; j <= N; j += oddOnly ? 2 * i : i) mLowestPrimeDiv.mark(j, i);
 
-  for (uint64_t i = 2; i <= N; i++)
-    if (mLowestPrimeDiv[i] == i) mAllPrimes.push_back(i);
+  mAllPrimes.push_back(2);
+  for (uint64_t i = 3; i <= N; i += oddOnly ? 2 : 1)
+    if (!mLowestPrimeDiv.is_composite(i)) mAllPrimes.push_back(i);
 }
 
-template <uint64_t N> bool PrimeSieve<N>::is_prime(uint64_t n) const
+template <uint64_t N, template <uint64_t> typename Storage>
+PrimeSieve<N, Storage>::PrimeSieve(prime::ParallelBuild conf)
 {
-  if (n == 0) throw std::invalid_argument("is prime: can't factor zero");
-  if (n == 1) return false;
-  if (n <= N) return mLowestPrimeDiv[n] == n;
+  Log(LL::Infra, "constructing a prime helper with N=$ on $ threads"_f, N, conf.maxThreads);
+  build_blocks(conf.maxThreads);
+}
 
-  for (prime_t p : mAllPrimes)
+template <uint64_t N, template <uint64_t> typename Storage>
+PrimeSieve<N, Storage>::PrimeSieve(prime::CacheFile conf)
+    : mMapping(load_cache(conf)),
+      mLowestPrimeDiv(mMapping ? Storage<N>(reinterpret_cast<const entry_t*>(mMapping->data() + cTableOffset))
+                               : Storage<N>())
+{
+  if (mMapping)
   {
-    if (p * p > n) return true;
-    if (n % p == 0) return false;
+    Log(LL::Infra, "mapped a prime helper with N=$ from $"_f, N, cache_path(conf).string());
+    const auto* primes = reinterpret_cast<const prime_t*>(mMapping->data() + cPrimesOffset);
+    mAllPrimes.assign(primes, primes + (mMapping->size() - cPrimesOffset) / sizeof(prime_t));
+    return;
   }
 
-  uint64_t candidate = mAllPrimes.back() + 2;
-  prime::detail::Wheel6 w(candidate);
-  for (; candidate * candidate <= n; candidate += w.advance())
-    if (n % candidate == 0) return false;
+  Log(LL::Infra, "constructing a prime helper with N=$ for cache $"_f, N, cache_path(conf).string());
+  build_blocks(std::thread::hardware_concurrency());
+  write_cache(conf);
+}
+
+template <uint64_t N, template <uint64_t> typename Storage>
+void PrimeSieve<N, Storage>::build_blocks(size_t maxThreads)
+{
+  constexpr uint64_t span = Storage<N>::cBlockSpan;
+  const uint64_t blocks   = N / span + 1;
+  const auto basePrimes   = prime::detail::primes_upto(prime::detail::isqrt(N));
+
+  // blocks touch disjoint parts of the table, only the per-block prime lists need merging
+  std::vector<std::vector<prime_t>> blockPrimes(blocks);
+  std::vector<uint64_t> blockIds(blocks);
+  std::iota(blockIds.begin(), blockIds.end(), 0);
+  utils::parallel::foreach(blockIds, [&](uint64_t b)
+  {
+    sieve_block(b * span, std::min((b + 1) * span, N + 1), basePrimes, blockPrimes[b]);
+  }, std::max<size_t>(maxThreads, 1));
+
+  mAllPrimes.reserve(N / std::log(N));
+  for (const auto& primes : blockPrimes) mAllPrimes.insert(mAllPrimes.end(), primes.begin(), primes.end());
+}
 
-  return true;
+template <uint64_t N, template <uint64_t> typename Storage>
+std::filesystem::path PrimeSieve<N, Storage>::cache_path(const prime::CacheFile& conf)
+{
+  return conf.dir / ("prime-sieve-" + std::string(Storage<N>::cName) + "-" + std::to_string(N) + ".bin");
 }
 
-template <uint64_t N> void PrimeSieve<N>::emit_factors(uint64_t n, auto callback) const
+template <uint64_t N, template <uint64_t> typename Storage>
+std::shared_ptr<const utils::MappedFile> PrimeSieve<N, Storage>::load_cache(const prime::CacheFile& conf)
 {
-  auto fastFactor = [&](uint64_t& n)
+  using prime::detail::CacheHeader;
+  auto path    = cache_path(conf);
+  auto mapping = utils::MappedFile::open(path);
+  if (!mapping) return nullptr;
+
+  const auto reject = [&](std::string_view why)
   {
-    while (n != 1)
-    {
-      callback(mLowestPrimeDiv[n]);
-      n /= mLowestPrimeDiv[n];
-    }
+    Log(LL::Warn, "ignoring sieve cache $: $"_f, path.string(), why);
+    return nullptr;
   };
 
-  if (n <= N) return fastFactor(n);
+  if (mapping->size() < cPrimesOffset) return reject("truncated");
+  CacheHeader header;
+  std::memcpy(&header, mapping->data(), sizeof(header));
+  if (header.magic != CacheHeader::cMagic) return reject("bad magic");
+  if (header.version != CacheHeader::cVersion) return reject("version mismatch");
+  if (header.n != N || header.entries != Storage<N>::cEntries || header.entryBytes != sizeof(entry_t))
+    return reject("built for a different sieve");
+  if (mapping->size() != cPrimesOffset + header.primeCount * sizeof(prime_t)) return reject("bad size");
+  if (conf.verify && header.checksum != hash::checksum(mapping->data() + cTableOffset,
+                                                       mapping->size() - cTableOffset))
+    return reject("checksum mismatch");
+
+  return mapping;
+}
+
+template <uint64_t N, template <uint64_t> typename Storage>
+void PrimeSieve<N, Storage>::write_cache(const prime::CacheFile& conf) const
+{
+  namespace fs = std::filesystem;
+
+  // table, zero pad up to cPrimesOffset, primes: streamed, never copied into one buffer
+  const auto table  = std::as_bytes(std::span(mLowestPrimeDiv.data(), Storage<N>::cEntries));
+  const auto primes = std::as_bytes(std::span(mAllPrimes));
+  const std::array<std::byte, 8> zeros{};
+  const auto pad = std::span(zeros).first(cPrimesOffset - cTableOffset - table.size());
+  const std::array pieces{table, std::span<const std::byte>(pad), primes};
 
-  for (prime_t p : mAllPrimes)
+  hash::Checksum checksum(cPrimesOffset - cTableOffset + primes.size());
+  for (const auto& piece : pieces) checksum.update(piece.data(), piece.size());
+
+  prime::detail::CacheHeader header{
+      .magic      = prime::detail::CacheHeader::cMagic,
+      .version    = prime::detail::CacheHeader::cVersion,
+      .entryBytes = sizeof(entry_t),
+      .n          = N,
+      .entries    = Storage<N>::cEntries,
+      .primeCount = mAllPrimes.size(),
+      .checksum   = checksum.digest(),
+      .reserved   = {},
+  };
+
+  // unique per writer, threads of one process included, so concurrent writers never share a temp file
+  const fs::path path = cache_path(conf);
+  const fs::path tmp  = path.string() + ".tmp" + std::to_string(::getpid()) + "-" +
+                       std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
   {
-    if (p * p > n)
+    std::ofstream out(tmp, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& piece : pieces)
+      out.write(reinterpret_cast<const char*>(piece.data()), static_cast<std::streamsize>(piece.size()));
+    // close first: the final flush can fail too
+    out.close();
+    if (!out)
     {
-      callback(n);
+      Log(LL::Warn, "could not write sieve cache $"_f, tmp.string());
+      std::error_code ec;
+      fs::remove(tmp, ec);
       return;
     }
-    while (n % p == 0)
+  }
+
+  std::error_code ec;
+  fs::rename(tmp, path, ec);
+  if (ec)
+  {
+    Log(LL::Warn, "could not publish sieve cache $: $"_f, path.string(), ec.message());
+    fs::remove(tmp, ec);
+  }
+}
+
+template <uint64_t N, template <uint64_t> typename Storage>
+void PrimeSieve<N, Storage>::sieve_block(uint64_t lo, uint64_t hi, const std::vector<prime_t>& basePrimes,
+                                         std::vector<prime_t>& out)
+{
+  constexpr bool oddOnly = Storage<N>::cOddOnly;
+  for (prime_t p : basePrimes)
+  {
+    if (oddOnly && p == 2) continue;
+    uint64_t j = std::max(p * p, (lo + p - 1) / p * p);
+    if (oddOnly && j % 2 == 0) j += p;
+    for (; j < hi; j += oddOnly ? 2 * p : p) mLowestPrimeDiv.mark(j, p);
+  }
+
+  if (lo <= 2 && 2 < hi) out.push_back(2);
+  for (uint64_t i = std::max<uint64_t>(lo, 3) | (oddOnly ? 1 : 0); i < hi; i += oddOnly ? 2 : 1)
+    if (!mLowestPrimeDiv.is_composite(i)) out.push_back(i);
+}
+
+template <uint64_t N, template <uint64_t> typename Storage>
+bool PrimeSieve<N, Storage>::is_prime(uint64_t n) const
+{
+  if (n == 0) throw std::invalid_argument("is prime: can't factor zero");
+  if (n == 1) return false;
+  if (n <= N) return !mLowestPrimeDiv.is_composite(n);
+  return prime::detail::is_prime_above(n, mAllPrimes, cTrialBound);
+}
+
+template <uint64_t N, template <uint64_t> typename Storage>
+void PrimeSieve<N, Storage>::emit_factors(uint64_t n, auto callback) const
+{
+  if (n == 0) throw std::invalid_argument("emit factors: can't factor zero");
+  const auto lowest = [&](uint64_t m) -> prime_t { return mLowestPrimeDiv.lowest(m); };
+  if (n > N) return prime::detail::emit_factors_above(n, N, mAllPrimes, cTrialBound, lowest, callback);
+  while (n != 1)
+  {
+    prime_t p = lowest(n);
+    callback(p);
+    n /= p;
+  }
+}
+
+/* StaticPrimeSieve
+ * - PrimeSieve's queries over tables built at compile time: odd-only lowest prime factors
+ *   and the prime list, both from maya, so an instance costs nothing at startup
+ * - queries up to N are constexpr; past N it falls back to Miller-Rabin and Pollard-Brent like PrimeSieve
+ * - compile-time budget: N up to ~1e5 per instantiation
+ * */
+template <uint64_t N> class StaticPrimeSieve : public prime::detail::FactorQueries<StaticPrimeSieve<N>>
+{
+  static_assert(N > 2);
+
+public:
+  using prime_t = uint64_t;
+  using exp_t   = uint64_t;
+
+  static constexpr prime_t cTrialBound = 1 << 9;
+
+  [[nodiscard]] constexpr bool is_prime(uint64_t n) const
+  {
+    if (n == 0) throw std::invalid_argument("is prime: can't factor zero");
+    if (n == 1) return false;
+    if (n <= N) return n == 2 || (n % 2 == 1 && maya::cOddLpf<N>[n / 2] == 0);
+    return prime::detail::is_prime_above(n, cPrimes, cTrialBound);
+  }
+
+  [[nodiscard]] constexpr std::span<const prime_t> all_primes() const { return cPrimes; }
+  // n <= N only, like PrimeSieve
+  [[nodiscard]] constexpr prime_t lowest_prime_factor(uint64_t n) const
+  {
+    if (n % 2 == 0) return 2;
+    prime_t p = maya::cOddLpf<N>[n / 2];
+    return p == 0 ? n : p;
+  }
+  // callback(p) once per prime factor with multiplicity, in sorted order
+  constexpr void emit_factors(uint64_t n, auto callback) const
+  {
+    if (n == 0) throw std::invalid_argument("emit factors: can't factor zero");
+    const auto lowest = [this](uint64_t m) { return lowest_prime_factor(m); };
+    if (n > N) return prime::detail::emit_factors_above(n, N, cPrimes, cTrialBound, lowest, callback);
+    while (n != 1)
     {
+      prime_t p = lowest(n);
       callback(p);
       n /= p;
-      if (n <= N) return fastFactor(n);
     }
   }
 
-  uint64_t candidate = mAllPrimes.back() + 2;
-  prime::detail::Wheel6 w(candidate);
-  for (; candidate * candidate <= n; candidate += w.advance())
+private:
+  static constexpr auto cPrimes = maya::primes_upto<N>();
+};
+
+/* DynamicPrimeSieve
+ * - PrimeSieve with a runtime bound: a query at or past limit() sieves further, at least doubling
+ *   the bound, so callers need not guess N up front
+ * - odd-only lowest prime factors like Compact, held in blocks that never move: block 0 covers
+ *   [0, cFirstBlock), block k covers [cFirstBlock 2^(k-1), cFirstBlock 2^k), growth only appends
+ * - new ranges are sieved segment by segment with base primes found once at construction
+ * - reads below limit() are lock free, growth is serialised on a mutex and published with the new
+ *   limit, so parallel workers can share one instance
+ * - past maxLimit nothing is sieved, is_prime and factoring fall back to Miller-Rabin and Pollard-Brent
+ * */
+class DynamicPrimeSieve : public prime::detail::FactorQueries<DynamicPrimeSieve>
+{
+public:
+  using prime_t = uint64_t;
+  using exp_t   = uint64_t;
+  using entry_t = uint16_t; // lpf(n) <= sqrt(n) < 2^16 below cMaxLimit
+
+  static constexpr prime_t cTrialBound   = 1 << 9;
+  static constexpr uint64_t cFirstBlock  = uint64_t{1} << 16;
+  static constexpr uint64_t cMaxLimit    = uint64_t{1} << 32;
+  static constexpr uint64_t cSegmentSpan = uint64_t{1} << 18; // 256KB of table per segment
+
+  explicit DynamicPrimeSieve(uint64_t limit = cFirstBlock, uint64_t maxLimit = cMaxLimit)
+      : mMaxLimit(validated(maxLimit)),
+        mBasePrimes(prime::detail::primes_upto(prime::detail::isqrt(mMaxLimit - 1)))
+  {
+    extend(std::max(limit, cFirstBlock));
+  }
+
+  // [0, limit()) is sieved
+  [[nodiscard]] uint64_t limit() const { return mLimit.load(std::memory_order_acquire); }
+  [[nodiscard]] uint64_t max_limit() const { return mMaxLimit; }
+
+  // sieve up to limit, clamped to max_limit(); safe to call while other threads query
+  void extend(uint64_t limit) { grow(limit); }
+
+  [[nodiscard]] bool is_prime(uint64_t n) const
+  {
+    if (n == 0) throw std::invalid_argument("is prime: can't factor zero");
+    if (n == 1) return false;
+    if (reach(n)) return lowest(n) == n;
+    return prime::detail::is_prime_above(n, mBasePrimes, cTrialBound);
+  }
+  // n < max_limit() only
+  [[nodiscard]] prime_t lowest_prime_factor(uint64_t n) const
+  {
+    if (!reach(n)) throw std::out_of_range("DynamicPrimeSieve: lowest_prime_factor past max_limit");
+    return lowest(n);
+  }
+  // callback(p) once per prime factor with multiplicity, in sorted order
+  void emit_factors(uint64_t n, auto callback) const
   {
-    while (n % candidate == 0)
+    if (n == 0) throw std::invalid_argument("emit factors: can't factor zero");
+    const auto table = [this](uint64_t m) { return lowest(m); };
+    if (!reach(n))
+      return prime::detail::emit_factors_above(n, limit() - 1, mBasePrimes, cTrialBound, table, callback);
+    while (n != 1)
     {
-      callback(candidate);
-      n /= candidate;
-      if (n <= N) return fastFactor(n);
+      prime_t p = lowest(n);
+      callback(p);
+      n /= p;
     }
   }
 
-  if (n != 1) callback(n);
+private:
+  static constexpr size_t cBlocks = std::bit_width((cMaxLimit - 1) / cFirstBlock) + 1;
+
+  [[nodiscard]] static uint64_t block_of(uint64_t n) { return std::bit_width(n / cFirstBlock); }
+  [[nodiscard]] static uint64_t block_start(uint64_t k) { return k == 0 ? 0 : cFirstBlock << (k - 1); }
+
+  // checked before any base prime is sieved off maxLimit
+  [[nodiscard]] static uint64_t validated(uint64_t maxLimit)
+  {
+    if (maxLimit < cFirstBlock || maxLimit > cMaxLimit)
+      throw std::invalid_argument("DynamicPrimeSieve: maxLimit out of [2^16, 2^32]");
+    return maxLimit;
+  }
+
+  // makes n < limit() when the cap allows it, growing geometrically
+  [[nodiscard]] bool reach(uint64_t n) const
+  {
+    uint64_t current = limit();
+    if (n < current) return true;
+    if (n >= mMaxLimit) return false;
+    grow(std::max(n + 1, 2 * current));
+    return true;
+  }
+
+  // queries grow the table too, hence const over the mutable state below
+  void grow(uint64_t limit) const
+  {
+    limit = std::min(limit, mMaxLimit);
+    std::lock_guard lock(mGrowth);
+    uint64_t lo = mLimit.load(std::memory_order_relaxed);
+    if (limit <= lo) return;
+    Log(LL::Infra, "growing a dynamic prime sieve from $ to $"_f, lo, limit);
+
+    while (lo < limit)
+    {
+      const uint64_t k = block_of(lo), blockEnd = block_start(k + 1);
+      if (!mBlocks[k]) mBlocks[k] = std::make_unique<entry_t[]>((blockEnd - block_start(k)) / 2);
+      const uint64_t hi = std::min({lo + cSegmentSpan, blockEnd, limit});
+      sieve_segment(lo, hi);
+      lo = hi;
+    }
+    mLimit.store(limit, std::memory_order_release);
+  }
+
+  // n < limit()
+  [[nodiscard]] prime_t lowest(uint64_t n) const
+  {
+    if (n % 2 == 0) return n == 0 ? 0 : 2;
+    const uint64_t k = block_of(n);
+    entry_t p        = mBlocks[k][(n - block_start(k)) / 2];
+    return p == 0 ? n : p;
+  }
+
+  // [lo, hi) inside one block, only the growing thread writes here
+  void sieve_segment(uint64_t lo, uint64_t hi) const
+  {
+    const uint64_t start = block_start(block_of(lo));
+    entry_t* table       = mBlocks[block_of(lo)].get();
+    for (prime_t p : mBasePrimes)
+    {
+      if (p == 2) continue;
+      if (p * p >= hi) break;
+      uint64_t j = std::max(p * p, (lo + p - 1) / p * p);
+      if (j % 2 == 0) j += p;
+      for (; j < hi; j += 2 * p)
+        if (table[(j - start) / 2] == 0) table[(j - start) / 2] = static_cast<entry_t>(p);
+    }
+  }
+
+  uint64_t mMaxLimit;
+  std::vector<prime_t> mBasePrimes; // every prime up to sqrt(mMaxLimit), also the trial divisors
+  mutable std::array<std::unique_ptr<entry_t[]>, cBlocks> mBlocks;
+  mutable std::atomic<uint64_t> mLimit = 0;
+  mutable std::mutex mGrowth;
+};
+
+/* PrimeRange
+ * - streams the primes in [lo, hi) with a segmented sieve of Eratosthenes
+ * - only the base primes up to sqrt(hi) and one odd-only segment live in memory,
+ *   so hi can go far past anything PrimeSieve<N> can hold (tested up to 1e13)
+ * - single pass: begin() can only be taken once meaningfully, like a generator
+ * */
+class PrimeRange
+{
+public:
+  // odd numbers per segment, one byte each; sized to sit in L2
+  static constexpr uint64_t cSegmentSize = uint64_t{1} << 18;
+
+  PrimeRange(uint64_t lo, uint64_t hi) : mHi(hi), mSegLo(std::max<uint64_t>(lo, 3) | 1)
+  {
+    if (hi <= lo) return;
+    mEmitTwo = lo <= 2 && 2 < hi;
+
+    auto base = prime::detail::primes_upto(prime::detail::isqrt(hi - 1));
+    for (uint64_t p : base)
+    {
+      if (p == 2) continue;
+      // first odd multiple of p that is >= max(p^2, segLo)
+      uint64_t start = std::max(p * p, (mSegLo + p - 1) / p * p);
+      if (start % 2 == 0) start += p;
+      mBasePrimes.push_back(p);
+      mNextMultiple.push_back(start);
+    }
+  }
+
+  struct Iterator
+  {
+    using value_type      = uint64_t;
+    using difference_type = std::ptrdiff_t;
+
+    [[nodiscard]] uint64_t operator*() const { return mRange->mCurrent; }
+    Iterator& operator++()
+    {
+      mRange->advance();
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+    [[nodiscard]] bool operator==(std::default_sentinel_t) const { return mRange->mDone; }
+
+    PrimeRange* mRange = nullptr;
+  };
+
+  [[nodiscard]] Iterator begin()
+  {
+    if (!mStarted)
+    {
+      mStarted = true;
+      advance();
+    }
+    return Iterator{this};
+  }
+  [[nodiscard]] std::default_sentinel_t end() const { return {}; }
+
+private:
+  void advance()
+  {
+    if (std::exchange(mEmitTwo, false))
+    {
+      mCurrent = 2;
+      return;
+    }
+
+    while (true)
+    {
+      while (mPos < mSegment.size())
+      {
+        if (mSegment[mPos++])
+        {
+          mCurrent = mSegLo + 2 * (mPos - 1);
+          return;
+        }
+      }
+      if (!mSegment.empty()) mSegLo += 2 * mSegment.size();
+      if (mSegLo >= mHi)
+      {
+        mDone = true;
+        return;
+      }
+      sieve_segment();
+    }
+  }
+
+  void sieve_segment()
+  {
+    uint64_t count = std::min(cSegmentSize, (mHi - mSegLo + 1) / 2);
+    uint64_t segHi = mSegLo + 2 * count;
+    mSegment.assign(count, 1);
+    mPos = 0;
+
+    for (size_t i = 0; i < mBasePrimes.size(); ++i)
+    {
+      uint64_t p = mBasePrimes[i];
+      if (p * p >= segHi) break;
+      uint64_t m = mNextMultiple[i];
+      for (; m < segHi; m += 2 * p) mSegment[(m - mSegLo) / 2] = 0;
+      mNextMultiple[i] = m;
+    }
+  }
+
+  uint64_t mHi;
+  uint64_t mSegLo; // odd, first number represented by mSegment[0]
+  uint64_t mCurrent = 0;
+  size_t mPos       = 0;
+  bool mEmitTwo     = false;
+  bool mStarted     = false;
+  bool mDone        = false;
+
+  std::vector<uint64_t> mBasePrimes; // odd primes up to sqrt(hi)
+  std::vector<uint64_t> mNextMultiple;
+  std::vector<char> mSegment;
+};
+
+/* FactorWindow
+ * - factors every integer in [lo, hi) at once: each base prime p <= sqrt(hi) walks its multiples in
+ *   the window and divides itself out, whatever is left above 1 is the one large prime factor
+ * - factorizations are packed back to back (CSR), factors(n) is a view sorted by prime
+ * - base primes can come from any sieve reaching sqrt(hi), so parallel workers can share them
+ * */
+class FactorWindow
+{
+public:
+  using prime_t     = uint64_t;
+  using exp_t       = uint64_t;
+  using prime_power = std::pair<prime_t, exp_t>;
+
+  // keeps every offset in uint32_t (a 64-bit n has at most 15 distinct primes) and the build, about 64 bytes
+  // per integer with the remainders, near 1 GB
+  static constexpr uint64_t cMaxWidth = uint64_t{1} << 24;
+
+  FactorWindow(uint64_t lo, uint64_t hi) : FactorWindow(lo, hi, base_primes(hi)) {}
+
+  FactorWindow(uint64_t lo, uint64_t hi, std::span<const prime_t> basePrimes) : mLo(lo), mHi(hi)
+  {
+    if (lo == 0) throw std::invalid_argument("FactorWindow: can't factor zero");
+    if (hi <= lo) return;
+    if (hi - lo > cMaxWidth) throw std::invalid_argument("FactorWindow: window too wide");
+    const uint64_t limit = prime::detail::isqrt(hi - 1);
+    if (!covers(basePrimes, limit)) throw std::invalid_argument("FactorWindow: base primes don't reach sqrt(hi)");
+
+    const size_t width = hi - lo;
+    std::vector<uint64_t> rest(width);
+    std::iota(rest.begin(), rest.end(), lo);
+
+    // pass 1 divides every base prime out of rest and counts the distinct primes per index, which sizes
+    // the packed table exactly; pass 2 walks the same multiples again and writes (p, e) straight into it
+    const auto each_multiple = [&](auto&& visit)
+    {
+      for (prime_t p : basePrimes)
+      {
+        if (p > limit) break;
+        for (uint64_t m = (lo + p - 1) / p * p; m < hi; m += p) visit(p, m);
+      }
+    };
+
+    mOffsets.assign(width + 1, 0);
+    each_multiple([&](prime_t p, uint64_t m)
+    {
+      uint64_t& r = rest[m - lo];
+      do
+      {
+        r /= p;
+      } while (r % p == 0);
+      ++mOffsets[m - lo + 1];
+    });
+    for (size_t i = 0; i < width; ++i) mOffsets[i + 1] += mOffsets[i] + (rest[i] > 1);
+
+    mFactors.resize(mOffsets[width]);
+    std::vector<uint32_t> fill(mOffsets.begin(), mOffsets.end() - 1);
+    each_multiple([&](prime_t p, uint64_t m)
+    {
+      exp_t e = 0;
+      for (uint64_t q = m; q % p == 0; q /= p) ++e;
+      mFactors[fill[m - lo]++] = {p, e};
+    });
+    for (size_t i = 0; i < width; ++i)
+      if (rest[i] > 1) mFactors[fill[i]] = {rest[i], 1};
+  }
+
+  [[nodiscard]] uint64_t lo() const { return mLo; }
+  [[nodiscard]] uint64_t hi() const { return mHi; }
+
+  // n must lie in [lo, hi)
+  [[nodiscard]] std::span<const prime_power> factors(uint64_t n) const
+  {
+    size_t i = n - mLo;
+    return {mFactors.data() + mOffsets[i], mFactors.data() + mOffsets[i + 1]};
+  }
+  [[nodiscard]] prime_t highest_prime_factor(uint64_t n) const
+  {
+    auto f = factors(n);
+    return f.empty() ? 1 : f.back().first;
+  }
+
+  [[nodiscard]] static std::vector<prime_t> base_primes(uint64_t hi)
+  {
+    return prime::detail::primes_upto(prime::detail::isqrt(hi == 0 ? 0 : hi - 1));
+  }
+
+private:
+  // the list must hold every prime up to limit, a sieve past limit may end on a prime below it
+  [[nodiscard]] static bool covers(std::span<const prime_t> primes, uint64_t limit)
+  {
+    if (limit < 2) return true;
+    if (primes.empty()) return false;
+    for (uint64_t c = primes.back() + 1; c <= limit; ++c)
+      if (prime::miller_rabin(c)) return false;
+    return true;
+  }
+
+  uint64_t mLo, mHi;
+  std::vector<uint32_t> mOffsets; // factors of lo + i live in [mOffsets[i], mOffsets[i + 1])
+  std::vector<prime_power> mFactors;
+};
+
+/* SmoothNumbers
+ * - the y-smooth numbers in [1, limit]: every prime factor <= y, 1 included
+ * - depth first over prime powers, each number is reached once as (smaller-smooth part) * q^k with q its
+ *   largest prime; only the primes up to y are kept, nothing proportional to limit
+ * - for_each is unsorted, for_each_with_largest(q) is the group whose largest prime is exactly q,
+ *   sorted() collects and sorts
+ * */
+class SmoothNumbers
+{
+public:
+  SmoothNumbers(uint64_t limit, uint64_t y) : mLimit(limit), mPrimes(prime::detail::primes_upto(y)) {}
+
+  [[nodiscard]] uint64_t limit() const { return mLimit; }
+  [[nodiscard]] std::span<const uint64_t> primes() const { return mPrimes; }
+
+  [[nodiscard]] bool is_smooth(uint64_t n) const
+  {
+    if (n == 0) throw std::invalid_argument("SmoothNumbers: zero has every prime factor");
+    for (uint64_t q : mPrimes)
+      while (n % q == 0) n /= q;
+    return n == 1;
+  }
+
+  void for_each(auto callback) const
+  {
+    if (mLimit >= 1) dfs(1, mPrimes.size(), callback);
+  }
+
+  // q must be one of primes()
+  void for_each_with_largest(uint64_t q, auto callback) const
+  {
+    auto it = std::ranges::lower_bound(mPrimes, q);
+    if (it == mPrimes.end() || *it != q) throw std::invalid_argument("SmoothNumbers: q is not a prime <= y");
+    const size_t idx = it - mPrimes.begin();
+    for (uint64_t v = q; v <= mLimit; v *= q)
+    {
+      dfs(v, idx, callback);
+      if (v > mLimit / q) break;
+    }
+  }
+
+  [[nodiscard]] std::vector<uint64_t> sorted() const
+  {
+    std::vector<uint64_t> result;
+    for_each([&](uint64_t v) { result.push_back(v); });
+    std::ranges::sort(result);
+    return result;
+  }
+
+private:
+  // value, then value times every product of primes[0, idx) up to the limit
+  void dfs(uint64_t value, size_t idx, auto& callback) const
+  {
+    callback(value);
+    for (size_t i = 0; i < idx && mPrimes[i] <= mLimit / value; ++i)
+      for (uint64_t v = value * mPrimes[i];; v *= mPrimes[i])
+      {
+        dfs(v, i, callback);
+        if (v > mLimit / mPrimes[i]) break;
+      }
+  }
+
+  uint64_t mLimit;
+  std::vector<uint64_t> mPrimes;
+};
+
+/* PrimeBitmap
+ * - primality of [0, limit()) packed on a mod 30 wheel: one byte per 30 integers, one bit per coprime residue
+ * - 1e10 fits in 333MB where PrimeSieve would take 80GB; every query touches a single cache line
+ * - grows in L1 sized segments via extend(), queries past limit() throw std::out_of_range
+ * */
+class PrimeBitmap
+{
+public:
+  static constexpr std::array<uint8_t, 8> cResidues = {1, 7, 11, 13, 17, 19, 23, 29};
+  // bytes per sieving segment
+  static constexpr uint64_t cSegmentBytes = uint64_t{1} << 15;
+
+  explicit PrimeBitmap(uint64_t limit = 0) { extend(limit); }
+
+  // rounded up to a multiple of 30
+  [[nodiscard]] uint64_t limit() const { return 30 * mBits.size(); }
+
+  void extend(uint64_t limit)
+  {
+    uint64_t oldBytes = mBits.size();
+    uint64_t newBytes = (limit + 29) / 30;
+    if (newBytes <= oldBytes) return;
+
+    mBits.resize(newBytes, 0xFF);
+    if (oldBytes == 0) mBits[0] &= ~uint8_t{1}; // 1 is not prime
+
+    auto base = prime::detail::primes_upto(prime::detail::isqrt(30 * newBytes - 1));
+    for (uint64_t lo = oldBytes; lo < newBytes; lo += cSegmentBytes)
+      sieve_segment(lo, std::min(lo + cSegmentBytes, newBytes), base);
+  }
+
+  [[nodiscard]] bool is_prime(uint64_t n) const
+  {
+    check_range(n);
+    if (n < 6) return n == 2 || n == 3 || n == 5;
+    uint8_t bit = cBitOf[n % 30];
+    return bit != cNone && (mBits[n / 30] >> bit & 1);
+  }
+
+  // smallest prime > n
+  [[nodiscard]] uint64_t next_prime(uint64_t n) const
+  {
+    if (auto p = find_next_prime(n)) return *p;
+    check_range(n);
+    throw std::out_of_range("PrimeBitmap: no prime above n below limit");
+  }
+  // smallest prime > n if it lies below limit(), for callers that extend() and retry
+  [[nodiscard]] std::optional<uint64_t> find_next_prime(uint64_t n) const
+  {
+    if (n < 5) return n < 2 ? 2 : n < 3 ? 3 : 5;
+    if (n >= limit()) return std::nullopt;
+    uint64_t byte = n / 30;
+    uint8_t bits  = mBits[byte] & cAbove[n % 30];
+    while (bits == 0)
+    {
+      if (++byte == mBits.size()) return std::nullopt;
+      bits = mBits[byte];
+    }
+    return 30 * byte + cResidues[std::countr_zero(bits)];
+  }
+
+  // largest prime < n, 0 if there is none
+  [[nodiscard]] uint64_t prev_prime(uint64_t n) const
+  {
+    if (n <= 7) return n <= 2 ? 0 : n == 3 ? 2 : n <= 5 ? 3 : 5;
+    check_range(n - 1);
+    uint64_t byte = (n - 1) / 30;
+    uint8_t bits  = mBits[byte] & cUpTo[(n - 1) % 30];
+    while (bits == 0)
+    {
+      if (byte == 0) return 5;
+      bits = mBits[--byte];
+    }
+    return 30 * byte + cResidues[std::bit_width(bits) - 1];
+  }
+
+private:
+  static constexpr uint8_t cNone = 0xFF;
+
+  // residue mod 30 -> bit index, cNone when the residue shares a factor with 30
+  static constexpr std::array<uint8_t, 30> cBitOf = []
+  {
+    std::array<uint8_t, 30> bitOf{};
+    bitOf.fill(cNone);
+    for (uint8_t k = 0; k < 8; ++k) bitOf[cResidues[k]] = k;
+    return bitOf;
+  }();
+  // residue r -> mask of bits whose residue is > r, resp. <= r
+  static constexpr std::array<uint8_t, 30> cAbove = []
+  {
+    std::array<uint8_t, 30> above{};
+    for (uint8_t r = 0; r < 30; ++r)
+      for (uint8_t k = 0; k < 8; ++k)
+        if (cResidues[k] > r) above[r] |= uint8_t(1 << k);
+    return above;
+  }();
+  static constexpr std::array<uint8_t, 30> cUpTo = []
+  {
+    std::array<uint8_t, 30> upTo{};
+    for (uint8_t r = 0; r < 30; ++r) upTo[r] = ~cAbove[r];
+    return upTo;
+  }();
+
+  void check_range(uint64_t n) const
+  {
+    if (n >= limit()) throw std::out_of_range("PrimeBitmap: query beyond limit, extend() first");
+  }
+
+  // clear composites in bytes [lo, hi); p * q with q = r (mod 30) steps p bytes per 30 q, always on the same bit
+  void sieve_segment(uint64_t lo, uint64_t hi, std::span<const uint64_t> base)
+  {
+    uint64_t segLo = 30 * lo, segHi = 30 * hi;
+    for (uint64_t p : base)
+    {
+      if (p < 7) continue;
+      if (p * p >= segHi) break;
+      uint64_t qMin = std::max(p, (segLo + p - 1) / p);
+      for (uint8_t r : cResidues)
+      {
+        uint64_t q = qMin + (r + 30 - qMin % 30) % 30;
+        uint64_t m = p * q;
+        if (m >= segHi) continue;
+        uint8_t mask = ~uint8_t(1 << cBitOf[m % 30]);
+        for (uint64_t byte = m / 30; byte < hi; byte += p) mBits[byte] &= mask;
+      }
+    }
+  }
+
+  std::vector<uint8_t> mBits;
+};
+
+/* PrimeSums
+ * - S(v) = sum of p^K over primes p <= v, for every v = x / n at once (Lucy_Hedgehog's dp)
+ * - 2 sqrt(x) values, O(x^{3/4} / log x) updates; pi(1e12) in under two seconds on one core
+ * - each sieving step walks bands of p-adic index ranges that never read each other, wide bands run in parallel
+ * - K = 0 counts in uint64, K = 1, 2 sum in 128 bits: exact up to x = 1e13
+ * */
+template <unsigned K> class PrimeSums
+{
+  static_assert(K <= 2, "PrimeSums: sums of p^K with K > 2 overflow 128 bits well before 1e13");
+
+public:
+  using value_t = std::conditional_t<K == 0, uint64_t, unsigned __int128>;
+
+  static constexpr uint64_t cMaxX = 10'000'000'000'000;
+  // entries per parallel work item; narrower bands stay on the calling thread
+  static constexpr uint64_t cParallelGrain = uint64_t{1} << 15;
+
+  explicit PrimeSums(uint64_t x, size_t maxThreads = std::thread::hardware_concurrency())
+      : mX(validated(x)), mSqrt(prime::detail::isqrt(mX)), mSmall(mSqrt + 1), mLarge(mSqrt + 1)
+  {
+    for (uint64_t v = 0; v <= mSqrt; ++v) mSmall[v] = prefix(v);
+    for (uint64_t i = 1; i <= mSqrt; ++i) mLarge[i] = prefix(x / i);
+    for (uint64_t p : prime::detail::primes_upto(mSqrt)) sieve_out(p, std::max<size_t>(maxThreads, 1));
+  }
+
+  // v must be of the form x / n
+  [[nodiscard]] value_t operator()(uint64_t v) const
+  {
+    if (v <= mSqrt) return mSmall[v];
+    if (v > mX || mX / (mX / v) != v) throw std::invalid_argument("PrimeSums: v is not x / n");
+    return mLarge[mX / v];
+  }
+
+  [[nodiscard]] uint64_t x() const { return mX; }
+
+private:
+  // checked before any table is sized off x
+  [[nodiscard]] static uint64_t validated(uint64_t x)
+  {
+    if (x > cMaxX) throw std::invalid_argument("PrimeSums: x beyond 1e13");
+    return x;
+  }
+
+  // sum of n^K over 2 <= n <= v
+  [[nodiscard]] static value_t prefix(uint64_t v)
+  {
+    if (v < 2) return 0;
+    if constexpr (K == 0) return v - 1;
+    else if constexpr (K == 1) return (v % 2 == 0 ? value_t{v / 2} * (v + 1) : value_t{v} * ((v + 1) / 2)) - 1;
+    else
+    {
+      value_t a = v, b = value_t{v} + 1, c = 2 * value_t{v} + 1;
+      (a % 2 == 0 ? a : b) /= 2;
+      (a % 3 == 0 ? a : b % 3 == 0 ? b : c) /= 3;
+      return a * b * c - 1;
+    }
+  }
+
+  // S(v) -= p^K (S(v / p) - S(p - 1)) for every v >= p^2, reading v / p before it is updated
+  void sieve_out(uint64_t p, size_t maxThreads)
+  {
+    value_t sp = mSmall[p - 1];
+    value_t gp = 1;
+    for (unsigned k = 0; k < K; ++k) gp *= p;
+
+    const auto drop = [&](value_t& s, value_t w)
+    {
+      if constexpr (K == 0)
+        s -= w - sp;
+      else
+        s -= gp * (w - sp);
+    };
+
+    // mLarge[i] reads mLarge[i * p], which lies in the band above (b / p, b]: lowest band first
+    std::vector<uint64_t> bounds{std::min(mSqrt, mX / (p * p))};
+    while (bounds.back() > 0) bounds.push_back(bounds.back() / p);
+    for (size_t j = bounds.size() - 1; j > 0; --j)
+    {
+      for_range(bounds[j] + 1, bounds[j - 1] + 1, maxThreads, [&](uint64_t i)
+      {
+        uint64_t d = i * p;
+        drop(mLarge[i], d <= mSqrt ? mLarge[d] : mSmall[mX / d]);
+      });
+    }
+
+    // mSmall[v] reads mSmall[v / p], which lies in the band below: highest band first
+    for (uint64_t hi = mSqrt; hi >= p * p; hi /= p)
+    {
+      uint64_t lo = std::max(hi / p + 1, p * p);
+      for_range(lo, hi + 1, maxThreads, [&](uint64_t v) { drop(mSmall[v], mSmall[v / p]); });
+    }
+  }
+
+  // func(i) for i in [lo, hi), in any order
+  static void for_range(uint64_t lo, uint64_t hi, size_t maxThreads, auto func)
+  {
+    if (hi <= lo) return;
+    if (maxThreads == 1 || hi - lo < 2 * cParallelGrain)
+    {
+      for (uint64_t i = lo; i < hi; ++i) func(i);
+      return;
+    }
+    std::vector<uint64_t> chunks;
+    for (uint64_t c = lo; c < hi; c += cParallelGrain) chunks.push_back(c);
+    utils::parallel::foreach (chunks, [&](uint64_t c)
+    {
+      for (uint64_t i = c; i < std::min(c + cParallelGrain, hi); ++i) func(i);
+    }, maxThreads);
+  }
+
+  uint64_t mX, mSqrt;
+  std::vector<value_t> mSmall; // S(v) for v <= sqrt(x)
+  std::vector<value_t> mLarge; // S(x / i) for i <= sqrt(x)
+};
+
+namespace prime {
+
+// number of primes <= x
+[[nodiscard]] inline uint64_t pi(uint64_t x) { return PrimeSums<0>(x)(x); }
+
+// sum of primes <= x
+[[nodiscard]] inline unsigned __int128 sum(uint64_t x) { return PrimeSums<1>(x)(x); }
+
+} // namespace prime
+
+namespace prime::arith {
+
+// MultiplicativeTable function selectors, or them together
+inline constexpr unsigned cPhi        = 1 << 0; // Euler's totient
+inline constexpr unsigned cMobius     = 1 << 1;
+inline constexpr unsigned cSigma      = 1 << 2; // sum of divisors
+inline constexpr unsigned cOmega      = 1 << 3; // number of distinct prime factors
+inline constexpr unsigned cLiouville  = 1 << 4; // (-1)^(prime factors with multiplicity)
+inline constexpr unsigned cCarmichael = 1 << 5; // exponent of (Z/nZ)^*
+inline constexpr unsigned cAll        = (1 << 6) - 1;
+
+} // namespace prime::arith
+
+/* MultiplicativeTable
+ * - f(n) for every n <= N and every f selected in Fns, each entry written once from n = p * m with p = lpf(n)
+ * - default: Euler's linear sieve, O(N) on one thread
+ * - ParallelBuild: lpf from a parallel CompactPrimeSieve, then rounds [lo, 2 lo) that only read below lo
+ * - only selected tables are allocated, each in the narrowest type that holds it
+ * */
+template <uint64_t N, unsigned Fns = prime::arith::cAll> class MultiplicativeTable
+{
+public:
+  using index_t = std::conditional_t<(N < (uint64_t{1} << 32)), uint32_t, uint64_t>;
+
+  // values below this are filled on the calling thread, as is each round's chunk
+  static constexpr uint64_t cSegment = uint64_t{1} << 16;
+
+  MultiplicativeTable();
+  explicit MultiplicativeTable(prime::ParallelBuild conf);
+
+  [[nodiscard]] index_t phi(uint64_t n) const
+    requires((Fns & prime::arith::cPhi) != 0)
+  {
+    return mPhi[n];
+  }
+  [[nodiscard]] int mobius(uint64_t n) const
+    requires((Fns & prime::arith::cMobius) != 0)
+  {
+    return mMobius[n];
+  }
+  [[nodiscard]] uint64_t sigma(uint64_t n) const
+    requires((Fns & prime::arith::cSigma) != 0)
+  {
+    return mSigma[n];
+  }
+  [[nodiscard]] unsigned omega(uint64_t n) const
+    requires((Fns & prime::arith::cOmega) != 0)
+  {
+    return mOmega[n];
+  }
+  [[nodiscard]] int liouville(uint64_t n) const
+    requires((Fns & prime::arith::cLiouville) != 0)
+  {
+    return mLiouville[n];
+  }
+  [[nodiscard]] index_t carmichael(uint64_t n) const
+    requires((Fns & prime::arith::cCarmichael) != 0)
+  {
+    return mCarmichael[n];
+  }
+
+private:
+  static constexpr bool has(unsigned f) { return (Fns & f) != 0; }
+
+  void allocate();
+  void set_one();
+  void set_prime(uint64_t p);
+  // n = p * m with p = lpf(n); every value this reads is at most n / 2
+  void set_composite(uint64_t n, uint64_t p, uint64_t m, bool pDividesM);
+
+  std::vector<index_t> mLowPower; // largest power of lpf(n) dividing n, dropped once built
+  std::vector<index_t> mPhi;
+  std::vector<int8_t> mMobius;
+  std::vector<uint64_t> mSigma;
+  std::vector<uint8_t> mOmega;
+  std::vector<int8_t> mLiouville;
+  std::vector<index_t> mCarmichael;
+};
+
+template <uint64_t N, unsigned Fns> MultiplicativeTable<N, Fns>::MultiplicativeTable()
+{
+  Log(LL::Infra, "constructing a multiplicative table with N=$", N);
+  allocate();
+
+  // mLowPower[i] == 0 marks i as not reached by any p * m yet, i.e. prime
+  std::vector<index_t> primes;
+  for (uint64_t i = 2; i <= N; ++i)
+  {
+    if (mLowPower[i] == 0)
+    {
+      set_prime(i);
+      primes.push_back(i);
+    }
+    for (uint64_t p : primes)
+    {
+      if (p * i > N) break;
+      bool divides = i % p == 0;
+      set_composite(p * i, p, i, divides);
+      if (divides) break;
+    }
+  }
+  std::vector<index_t>().swap(mLowPower);
+}
+
+template <uint64_t N, unsigned Fns>
+MultiplicativeTable<N, Fns>::MultiplicativeTable(prime::ParallelBuild conf)
+{
+  Log(LL::Infra, "constructing a multiplicative table with N=$ on $ threads"_f, N, conf.maxThreads);
+  allocate();
+  const CompactPrimeSieve<N> sieve{conf};
+
+  const auto fill = [&](uint64_t n)
+  {
+    uint64_t p = sieve.lowest_prime_factor(n);
+    if (p == n) return set_prime(n);
+    uint64_t m = n / p;
+    set_composite(n, p, m, m > 1 && sieve.lowest_prime_factor(m) == p);
+  };
+
+  const uint64_t serialEnd = std::min(cSegment, N + 1);
+  for (uint64_t n = 2; n < serialEnd; ++n) fill(n);
+
+  std::vector<uint64_t> chunks;
+  for (uint64_t lo = serialEnd; lo <= N; lo *= 2)
+  {
+    uint64_t hi = std::min(2 * lo, N + 1);
+    chunks.clear();
+    for (uint64_t c = lo; c < hi; c += cSegment) chunks.push_back(c);
+    utils::parallel::foreach (chunks, [&](uint64_t c)
+    {
+      for (uint64_t n = c; n < std::min(c + cSegment, hi); ++n) fill(n);
+    }, std::max<size_t>(conf.maxThreads, 1));
+  }
+  std::vector<index_t>().swap(mLowPower);
+}
+
+template <uint64_t N, unsigned Fns> void MultiplicativeTable<N, Fns>::allocate()
+{
+  using namespace prime::arith;
+  mLowPower.resize(N + 1);
+  if constexpr (has(cPhi)) mPhi.resize(N + 1);
+  if constexpr (has(cMobius)) mMobius.resize(N + 1);
+  if constexpr (has(cSigma)) mSigma.resize(N + 1);
+  if constexpr (has(cOmega)) mOmega.resize(N + 1);
+  if constexpr (has(cLiouville)) mLiouville.resize(N + 1);
+  if constexpr (has(cCarmichael)) mCarmichael.resize(N + 1);
+  if constexpr (N >= 1) set_one();
+}
+
+template <uint64_t N, unsigned Fns> void MultiplicativeTable<N, Fns>::set_one()
+{
+  using namespace prime::arith;
+  mLowPower[1] = 1;
+  if constexpr (has(cPhi)) mPhi[1] = 1;
+  if constexpr (has(cMobius)) mMobius[1] = 1;
+  if constexpr (has(cSigma)) mSigma[1] = 1;
+  if constexpr (has(cLiouville)) mLiouville[1] = 1;
+  if constexpr (has(cCarmichael)) mCarmichael[1] = 1;
+}
+
+template <uint64_t N, unsigned Fns> void MultiplicativeTable<N, Fns>::set_prime(uint64_t p)
+{
+  using namespace prime::arith;
+  mLowPower[p] = p;
+  if constexpr (has(cPhi)) mPhi[p] = p - 1;
+  if constexpr (has(cMobius)) mMobius[p] = -1;
+  if constexpr (has(cSigma)) mSigma[p] = p + 1;
+  if constexpr (has(cOmega)) mOmega[p] = 1;
+  if constexpr (has(cLiouville)) mLiouville[p] = -1;
+  if constexpr (has(cCarmichael)) mCarmichael[p] = p - 1;
+}
+
+template <uint64_t N, unsigned Fns>
+void MultiplicativeTable<N, Fns>::set_composite(uint64_t n, uint64_t p, uint64_t m, bool pDividesM)
+{
+  using namespace prime::arith;
+  if constexpr (has(cLiouville)) mLiouville[n] = -mLiouville[m];
+
+  if (!pDividesM)
+  {
+    // gcd(p, m) = 1: multiply in f(p)
+    mLowPower[n] = p;
+    if constexpr (has(cPhi)) mPhi[n] = mPhi[m] * (p - 1);
+    if constexpr (has(cMobius)) mMobius[n] = -mMobius[m];
+    if constexpr (has(cSigma)) mSigma[n] = mSigma[m] * (p + 1);
+    if constexpr (has(cOmega)) mOmega[n] = mOmega[m] + 1;
+    if constexpr (has(cCarmichael)) mCarmichael[n] = std::lcm(mCarmichael[m], index_t(p - 1));
+    return;
+  }
+
+  // n = pe * rest with pe = p^e, e >= 2
+  uint64_t pe   = uint64_t{mLowPower[m]} * p;
+  uint64_t rest = n / pe;
+  mLowPower[n]  = pe;
+  if constexpr (has(cPhi)) mPhi[n] = mPhi[m] * p;
+  if constexpr (has(cMobius)) mMobius[n] = 0;
+  if constexpr (has(cOmega)) mOmega[n] = mOmega[m];
+  if constexpr (has(cSigma)) mSigma[n] = rest == 1 ? mSigma[m] * p + 1 : mSigma[rest] * mSigma[pe];
+  if constexpr (has(cCarmichael))
+  {
+    if (rest > 1)
+      mCarmichael[n] = std::lcm(mCarmichael[rest], mCarmichael[pe]);
+    else // lambda(2^e) = 2^(e-2) from 8 on, phi(p^e) otherwise
+      mCarmichael[n] = p == 2 && n >= 8 ? n / 4 : m * (p - 1);
+  }
 }
@@ -1,8 +1,6 @@
 #include <stdexcept>
 #include <utils/PrimeInt.hpp>
 
-const PrimeSieve<PrimeInt::SmallN> PrimeInt::factorizer{};
-
 std::ostream& operator<<(std::ostream& out, const PrimeInt& m)
 {
   bool first = true;
@@ -10,9 +10,9 @@
 
 class PrimeInt
 {
-  // support auto factorization of primes using Prime<SmallN>
-  static constexpr size_t SmallN = 500;
-  static const PrimeSieve<SmallN> factorizer;
+  // support auto factorization of primes using StaticPrimeSieve<SmallN>, tables baked in at compile time
+  static constexpr size_t SmallN = 1 << 12;
+  static constexpr StaticPrimeSieve<SmallN> factorizer{};
 
 public:
   PrimeInt() = default;
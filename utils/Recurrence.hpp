@@ -0,0 +1,148 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <math/Basic.hpp>
+#include <optional>
+#include <stdexcept>
+#include <utils/ModInt.hpp>
+#include <utils/Poly.hpp>
+#include <vector>
+
+/* LinearRecurrence
+ * - a_n = c_1 a_(n-1) + ... + c_d a_(n-d) from d initial terms, over ModInt<Mods...>: every Mod an NTT
+ *   prime, several of them so ntt::reconstruct gives back terms below their product exactly
+ * - find() runs Berlekamp-Massey once per prime and pads the shorter recurrences with zero coefficients;
+ *   the result is only trusted when the terms outnumber twice the order, otherwise std::nullopt
+ * - nth(n) is Kitamasa: x^n mod the characteristic polynomial by squaring, each step a Poly product and
+ *   a reduction through the precomputed inverse of the reversed polynomial: O(d log d log n)
+ * */
+template <uint32_t... Mods> class LinearRecurrence
+{
+public:
+  using M = ModInt<Mods...>;
+
+  LinearRecurrence(std::vector<M> initial, std::vector<M> coeffs)
+      : mInitial(std::move(initial)), mCoeffs(std::move(coeffs))
+  {
+    if (mInitial.size() < mCoeffs.size())
+      throw std::invalid_argument("LinearRecurrence: fewer initial terms than the order");
+    mInitial.resize(mCoeffs.size());
+
+    // Q(x) = x^d - c_1 x^(d-1) - ... - c_d, and 1 / rev(Q) to d terms for the reductions
+    std::vector<M> rev(order() + 1);
+    rev[0] = M(1);
+    for (size_t j = 0; j < order(); ++j) rev[j + 1] = -mCoeffs[j];
+    mCharPoly   = Poly<M>(std::vector<M>(rev.rbegin(), rev.rend()));
+    mInverseRev = Poly<M>(std::move(rev)).inverse(order());
+  }
+
+  // the shortest recurrence every term satisfies, if the terms pin it down
+  [[nodiscard]] static std::optional<LinearRecurrence> find(const std::vector<M>& terms)
+  {
+    std::vector<std::vector<uint32_t>> perMod;
+    size_t k = 0;
+    (perMod.push_back(berlekamp_massey(terms, k++, Mods)), ...);
+
+    size_t d = 0;
+    for (const auto& c : perMod) d = std::max(d, c.size());
+    if (2 * d >= terms.size()) return std::nullopt;
+
+    std::vector<M> coeffs(d);
+    for (size_t i = 0; i < perMod.size(); ++i)
+      for (size_t j = 0; j < perMod[i].size(); ++j) coeffs[j].mVals[i] = perMod[i][j];
+    return LinearRecurrence(std::vector<M>(terms.begin(), terms.begin() + d), std::move(coeffs));
+  }
+
+  // integer terms, e.g. from utils::read_bfile, reduced mod each prime
+  template <std::integral T>
+  [[nodiscard]] static std::optional<LinearRecurrence> find(const std::vector<T>& terms)
+  {
+    std::vector<M> lifted(terms.size());
+    for (size_t i = 0; i < terms.size(); ++i)
+    {
+      if constexpr (std::is_signed_v<T>)
+        if (terms[i] < 0) throw std::invalid_argument("LinearRecurrence: terms must be non-negative");
+      size_t k = 0;
+      ((lifted[i].mVals[k++] = static_cast<uint32_t>(static_cast<uint64_t>(terms[i]) % Mods)), ...);
+    }
+    return find(lifted);
+  }
+
+  [[nodiscard]] size_t order() const { return mCoeffs.size(); }
+  [[nodiscard]] const std::vector<M>& coefficients() const { return mCoeffs; }
+  [[nodiscard]] const std::vector<M>& initial() const { return mInitial; }
+
+  [[nodiscard]] M nth(uint64_t n) const
+  {
+    if (n < order()) return mInitial[n];
+    if (order() == 0) return M(0);
+
+    // x^n mod Q = sum r_i x^i, so a_n = sum r_i a_i
+    Poly<M> r{M(1)};
+    for (int bit = std::bit_width(n) - 1; bit >= 0; --bit)
+    {
+      r = reduce(r * r);
+      if ((n >> bit) & 1) r = reduce(Poly<M>{M(0), M(1)} * r);
+    }
+
+    M value = 0;
+    for (size_t i = 0; i < order(); ++i) value += r[i] * mInitial[i];
+    return value;
+  }
+
+private:
+  // p mod Q for deg p < 2d: the quotient's reversal is rev(p) / rev(Q) to deg p - d + 1 terms
+  [[nodiscard]] Poly<M> reduce(const Poly<M>& p) const
+  {
+    const size_t d = order();
+    if (p.size() <= d) return p;
+
+    const size_t k = p.size() - d;
+    std::vector<M> rev(k);
+    for (size_t i = 0; i < k; ++i) rev[i] = p[p.size() - 1 - i];
+    const Poly<M> q = (Poly<M>(std::move(rev)) * mInverseRev.truncated(k)).truncated(k);
+    std::vector<M> quotient(q.coeffs().rbegin(), q.coeffs().rend());
+    return (p - mCharPoly * Poly<M>(std::move(quotient))).truncated(d);
+  }
+
+  // c_1..c_L mod one prime, the k-th component of the terms
+  [[nodiscard]] static std::vector<uint32_t> berlekamp_massey(const std::vector<M>& terms, size_t k,
+                                                              uint64_t mod)
+  {
+    // connection polynomials C, and B from the last length change, both with constant term 1
+    std::vector<uint64_t> c{1}, b{1};
+    uint64_t lastDiscrepancy = 1;
+    size_t length = 0, shift = 1;
+    for (size_t i = 0; i < terms.size(); ++i, ++shift)
+    {
+      uint64_t discrepancy = 0;
+      for (size_t j = 0; j < c.size() && j <= length; ++j)
+        discrepancy = (discrepancy + c[j] * terms[i - j].mVals[k]) % mod;
+      if (discrepancy == 0) continue;
+
+      const uint64_t scale = discrepancy * math::pow(lastDiscrepancy, mod - 2, mod) % mod;
+      const auto previous  = c;
+      if (c.size() < b.size() + shift) c.resize(b.size() + shift);
+      for (size_t j = 0; j < b.size(); ++j) c[j + shift] = (c[j + shift] + mod - scale * b[j] % mod) % mod;
+      if (2 * length <= i)
+      {
+        length          = i + 1 - length;
+        b               = previous;
+        lastDiscrepancy = discrepancy;
+        shift           = 0;
+      }
+    }
+
+    c.resize(length + 1);
+    std::vector<uint32_t> coeffs(length);
+    for (size_t j = 1; j <= length; ++j) coeffs[j - 1] = static_cast<uint32_t>((mod - c[j]) % mod);
+    return coeffs;
+  }
+
+  std::vector<M> mInitial;
+  std::vector<M> mCoeffs;
+  Poly<M> mCharPoly;
+  Poly<M> mInverseRev;
+};
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utils/Fft.hpp>
+#include <utils/Parallel.hpp>
+#include <vector>
+
+/* SumsetCounter
+ * - r(s) = #{(a, b) in A x A : a + b = s} for a set A in [0, n) that only grows, kept for s < sumLimit
+ * - insert(delta) applies (f + d)^2 = f^2 + 2 f d + d^2 for the indicators f of A and d of delta:
+ *   a small delta pairs each new element with the members directly, |delta| |A| additions; once that
+ *   passes the cost of a transform, r is recomputed with one fft::exact_self_convolution instead,
+ *   which is cheaper than the two convolutions the identity would take
+ * - counts never drop, so the zeros are kept as a bitset and first_zero scans 64 sums per word
+ * */
+class SumsetCounter
+{
+public:
+  // pair additions that cost as much as one unit of a transform's n log2 n, measured at N = 2.2M
+  static constexpr double cDenseFactor = 0.6;
+
+  SumsetCounter(size_t n, size_t sumLimit)
+      : mIn(n, 0), mCounts(sumLimit, 0), mZeros((sumLimit + 63) / 64, ~uint64_t{0})
+  {
+    if (sumLimit % 64) mZeros.back() = (uint64_t{1} << (sumLimit % 64)) - 1;
+  }
+  explicit SumsetCounter(size_t n) : SumsetCounter(n, n == 0 ? 0 : 2 * n - 1) {}
+
+  [[nodiscard]] size_t size() const { return mIn.size(); }
+  [[nodiscard]] size_t sum_limit() const { return mCounts.size(); }
+  [[nodiscard]] const std::vector<uint64_t>& members() const { return mMembers; }
+  [[nodiscard]] bool contains(uint64_t a) const { return a < mIn.size() && mIn[a]; }
+
+  [[nodiscard]] uint64_t count(size_t s) const { return mCounts.at(s); }
+  [[nodiscard]] const std::vector<uint64_t>& counts() const { return mCounts; }
+
+  // smallest s >= from below sum_limit() that no pair reaches
+  [[nodiscard]] std::optional<size_t> first_zero(size_t from = 0) const
+  {
+    if (from >= mCounts.size()) return std::nullopt;
+    size_t w      = from / 64;
+    uint64_t bits = mZeros[w] & (~uint64_t{0} << (from % 64));
+    while (bits == 0)
+    {
+      if (++w == mZeros.size()) return std::nullopt;
+      bits = mZeros[w];
+    }
+    return w * 64 + std::countr_zero(bits);
+  }
+
+  // adds the elements of delta to A; members and repeats are skipped
+  void insert(std::span<const uint64_t> delta)
+  {
+    const size_t before = mMembers.size();
+    for (uint64_t x : delta)
+    {
+      if (x >= mIn.size()) throw std::out_of_range("SumsetCounter: element past the universe");
+      if (mIn[x]) continue;
+      mIn[x] = 1;
+      mMembers.push_back(x);
+    }
+    const size_t added = mMembers.size() - before;
+    if (added == 0) return;
+
+    const double n = static_cast<double>(std::bit_ceil(2 * mIn.size()));
+    if (static_cast<double>(added) * static_cast<double>(mMembers.size()) > cDenseFactor * n * std::log2(n))
+      recount();
+    else
+      for (size_t i = before; i < mMembers.size(); ++i) pair_with_earlier(i);
+  }
+
+  void insert(uint64_t x) { insert(std::span<const uint64_t>(&x, 1)); }
+
+private:
+  void bump(size_t s, uint64_t by)
+  {
+    if (s >= mCounts.size()) return;
+    if (mCounts[s] == 0) mZeros[s / 64] &= ~(uint64_t{1} << (s % 64));
+    mCounts[s] += by;
+  }
+
+  // the terms of 2 f d + d^2 that member i adds on top of everything before it
+  void pair_with_earlier(size_t i)
+  {
+    const uint64_t x = mMembers[i];
+    bump(2 * x, 1);
+    for (size_t j = 0; j < i; ++j) bump(mMembers[j] + x, 2);
+  }
+
+  void recount()
+  {
+    auto full = fft::exact_self_convolution(mIn);
+    full.resize(mCounts.size(), 0);
+    mCounts = std::move(full);
+    for (size_t w = 0; w < mZeros.size(); ++w)
+    {
+      uint64_t bits = 0;
+      for (size_t s = w * 64; s < std::min(w * 64 + 64, mCounts.size()); ++s)
+        bits |= uint64_t{mCounts[s] == 0} << (s % 64);
+      mZeros[w] = bits;
+    }
+  }
+
+  std::vector<uint8_t> mIn;
+  std::vector<uint64_t> mMembers;
+  std::vector<uint64_t> mCounts;
+  std::vector<uint64_t> mZeros; // bit s % 64 of word s / 64 set while r(s) == 0
+};
+
+namespace sumset::detail {
+
+// unaligned views of the word arrays, one lane per word
+using U1 = uint64_t;
+using U4 = uint64_t __attribute__((vector_size(4 * sizeof(uint64_t)), may_alias, aligned(8)));
+using U8 = uint64_t __attribute__((vector_size(8 * sizeof(uint64_t)), may_alias, aligned(8)));
+
+template <typename V> [[gnu::always_inline]] inline uint64_t lane(const V& v, size_t l)
+{
+  if constexpr (std::is_same_v<V, U1>)
+    return v;
+  else
+    return v[l];
+}
+
+// sum over k < words of popcount(x[k] & y'[k]), y' being the bitset y read from bit offset on, so word
+// k of y' straddles y[offset / 64 + k] and the one after it, which must be readable. AnyOnly returns 1
+// at the first common bit instead of counting them all
+template <typename V, bool AnyOnly>
+[[gnu::always_inline]] inline uint64_t and_popcount(const uint64_t* x, const uint64_t* y, size_t words,
+                                                    size_t offset)
+{
+  constexpr size_t W = sizeof(V) / sizeof(uint64_t);
+  const unsigned lo  = offset % 64;
+  y += offset / 64;
+
+  // (next << (63 - lo)) << 1 shifts in nothing when lo == 0, where next << 64 would be undefined;
+  // spelled out in both loops since a helper returning V would cross a call by value
+  uint64_t total = 0;
+  size_t k       = 0;
+  for (; k + W <= words; k += W)
+  {
+    const V here = *reinterpret_cast<const V*>(y + k), next = *reinterpret_cast<const V*>(y + k + 1);
+    const V hit  = *reinterpret_cast<const V*>(x + k) & ((here >> lo) | ((next << (63 - lo)) << 1));
+    if constexpr (AnyOnly)
+    {
+      uint64_t any = 0;
+      for (size_t l = 0; l < W; ++l) any |= lane(hit, l);
+      if (any) return 1;
+    }
+    else
+      for (size_t l = 0; l < W; ++l) total += std::popcount(lane(hit, l));
+  }
+  for (; k < words; ++k)
+  {
+    const uint64_t hit = x[k] & ((y[k] >> lo) | ((y[k + 1] << (63 - lo)) << 1));
+    if constexpr (AnyOnly)
+    {
+      if (hit) return 1;
+    }
+    else
+      total += std::popcount(hit);
+  }
+  return total;
+}
+
+template <bool AnyOnly>
+inline uint64_t and_popcount_scalar(const uint64_t* x, const uint64_t* y, size_t words, size_t offset)
+{
+  return and_popcount<U1, AnyOnly>(x, y, words, offset);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+template <bool AnyOnly>
+[[gnu::target("avx2,popcnt")]] inline uint64_t and_popcount_avx2(const uint64_t* x, const uint64_t* y,
+                                                                 size_t words, size_t offset)
+{
+  return and_popcount<U4, AnyOnly>(x, y, words, offset);
+}
+
+template <bool AnyOnly>
+[[gnu::target("avx512f,popcnt")]] inline uint64_t and_popcount_avx512(const uint64_t* x, const uint64_t* y,
+                                                                      size_t words, size_t offset)
+{
+  return and_popcount<U8, AnyOnly>(x, y, words, offset);
+}
+#endif
+
+template <bool AnyOnly>
+inline uint64_t and_popcount(const uint64_t* x, const uint64_t* y, size_t words, size_t offset,
+                             fft::Simd simd)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  if (simd == fft::Simd::Avx512) return and_popcount_avx512<AnyOnly>(x, y, words, offset);
+  if (simd == fft::Simd::Avx2) return and_popcount_avx2<AnyOnly>(x, y, words, offset);
+#endif
+  return and_popcount_scalar<AnyOnly>(x, y, words, offset);
+}
+
+} // namespace sumset::detail
+
+/* SumsetEngine
+ * - a set A in [0, n) packed into 64-bit words, kept alongside its mirror R[i] = A[n - 1 - i]
+ * - r(t) = #{(a, b) : a + b = t} is sum_j A[j] R[j + n - 1 - t]: one AND of A against R read from a bit
+ *   offset, popcounted word by word, 4 or 8 words per step on AVX2 / AVX-512 (same runtime choice as
+ *   the fft kernels); has_sum stops at the first common bit
+ * - difference counts A - B are the same kernel on A and B itself, no mirror needed
+ * - full count vectors go word by word up to cFftCrossover and through fft::exact_convolution past it
+ * */
+class SumsetEngine
+{
+public:
+  // universe size where the O(n^2 / 64) word kernel loses to the O(n log n) transform
+  static constexpr size_t cFftCrossover = 1 << 12;
+
+  explicit SumsetEngine(size_t n) : mSize(n), mBits(words() + 1, 0), mMirror(words() + 1, 0) {}
+
+  [[nodiscard]] size_t size() const { return mSize; }
+  [[nodiscard]] size_t words() const { return (mSize + 63) / 64; }
+  [[nodiscard]] bool test(size_t a) const { return a < mSize && (mBits[a / 64] >> (a % 64) & 1); }
+
+  void set(size_t a)
+  {
+    check(a);
+    mBits[a / 64] |= uint64_t{1} << (a % 64);
+    mMirror[(mSize - 1 - a) / 64] |= uint64_t{1} << ((mSize - 1 - a) % 64);
+  }
+  void reset(size_t a)
+  {
+    check(a);
+    mBits[a / 64] &= ~(uint64_t{1} << (a % 64));
+    mMirror[(mSize - 1 - a) / 64] &= ~(uint64_t{1} << ((mSize - 1 - a) % 64));
+  }
+
+  // r(t), ordered pairs, a == b included
+  [[nodiscard]] uint64_t sum_count(size_t t, fft::Simd simd = fft::best_simd()) const
+  {
+    return pair_sum<false>(t, simd);
+  }
+  [[nodiscard]] bool has_sum(size_t t, fft::Simd simd = fft::best_simd()) const
+  {
+    return pair_sum<true>(t, simd);
+  }
+
+  // has_sum for every target, spread over threads
+  [[nodiscard]] std::vector<char> has_sums(std::span<const uint64_t> targets,
+                                           size_t maxThreads = std::thread::hardware_concurrency()) const
+  {
+    constexpr size_t cChunk = 256;
+    std::vector<char> result(targets.size());
+    std::vector<size_t> starts;
+    for (size_t i = 0; i < targets.size(); i += cChunk) starts.push_back(i);
+    const fft::Simd simd = fft::best_simd();
+    utils::parallel::foreach (starts, [&](size_t i0)
+    {
+      for (size_t i = i0; i < std::min(i0 + cChunk, targets.size()); ++i)
+        result[i] = has_sum(targets[i], simd);
+    }, std::max<size_t>(maxThreads, 1));
+    return result;
+  }
+
+  // r(t) for every t < 2 n - 1
+  [[nodiscard]] std::vector<uint64_t> sum_counts() const
+  {
+    if (mSize == 0) return {};
+    if (mSize > cFftCrossover) return fft::exact_self_convolution(indicator());
+    std::vector<uint64_t> r(2 * mSize - 1);
+    const fft::Simd simd = fft::best_simd();
+    for (size_t t = 0; t < r.size(); ++t) r[t] = sum_count(t, simd);
+    return r;
+  }
+
+  // d[k] = #{(a, b) in A x B : a - b = k - (B.size() - 1)} for k < size() + B.size() - 1
+  [[nodiscard]] std::vector<uint64_t> difference_counts(const SumsetEngine& other) const
+  {
+    if (mSize == 0 || other.mSize == 0) return {};
+    if (std::max(mSize, other.mSize) > cFftCrossover)
+    {
+      auto mirrored = other.indicator();
+      std::ranges::reverse(mirrored);
+      return fft::exact_convolution(indicator(), mirrored);
+    }
+
+    std::vector<uint64_t> d(mSize + other.mSize - 1);
+    const fft::Simd simd = fft::best_simd();
+    const size_t zero    = other.mSize - 1;
+    // a - b = k >= 0 pairs B[b] with A[b + k], a - b = -k pairs A[a] with B[a + k]
+    for (size_t k = 0; k < mSize; ++k) d[zero + k] = shifted_and(other.mBits, mBits, k, simd);
+    for (size_t k = 1; k < other.mSize; ++k) d[zero - k] = shifted_and(mBits, other.mBits, k, simd);
+    return d;
+  }
+
+private:
+  void check(size_t a) const
+  {
+    if (a >= mSize) throw std::out_of_range("SumsetEngine: element past the universe");
+  }
+
+  [[nodiscard]] std::vector<uint8_t> indicator() const
+  {
+    std::vector<uint8_t> f(mSize);
+    for (size_t a = 0; a < mSize; ++a) f[a] = test(a);
+    return f;
+  }
+
+  // sum_j x[j] y[j + offset], both padded with a zero word past their last
+  template <bool AnyOnly = false>
+  [[nodiscard]] static uint64_t shifted_and(const std::vector<uint64_t>& x, const std::vector<uint64_t>& y,
+                                            size_t offset, fft::Simd simd)
+  {
+    const size_t yWords = y.size() - 1;
+    if (offset / 64 >= yWords) return 0;
+    const size_t words = std::min(x.size() - 1, yWords - offset / 64);
+    return sumset::detail::and_popcount<AnyOnly>(x.data(), y.data(), words, offset, simd);
+  }
+
+  // A[j] A[t - j] = A[j] R[j + n - 1 - t]; past t = n - 1 the roles of A and R swap
+  template <bool AnyOnly> [[nodiscard]] uint64_t pair_sum(size_t t, fft::Simd simd) const
+  {
+    if (mSize == 0 || t > 2 * (mSize - 1)) return 0;
+    if (t <= mSize - 1) return shifted_and<AnyOnly>(mBits, mMirror, mSize - 1 - t, simd);
+    return shifted_and<AnyOnly>(mMirror, mBits, t - (mSize - 1), simd);
+  }
+
+  size_t mSize;
+  std::vector<uint64_t> mBits, mMirror; // words() words and a zero pad word
+};
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cstdint>
+#include <type_traits>
 #include <math/Basic.hpp>
 
 namespace maya {
@@ -26,12 +27,41 @@ namespace maya {
   return count;
 }
 
-template <size_t N> [[nodiscard]] consteval std::array<uint64_t, prime_count(N)> primes_upto()
+namespace detail {
+
+template <uint64_t N> using lpf_entry_t = std::conditional_t<(N < (uint64_t{1} << 32)), uint16_t, uint32_t>;
+
+// lowest prime factor of odd n at [n / 2], 0 for 1 and for primes. even n are left to the caller
+template <uint64_t N> [[nodiscard]] consteval std::array<lpf_entry_t<N>, N / 2 + 1> odd_lpf_table()
+{
+  std::array<lpf_entry_t<N>, N / 2 + 1> lpf{};
+  for (uint64_t i = 3; i * i <= N; i += 2)
+    if (lpf[i / 2] == 0)
+      for (uint64_t j = i * i; j <= N; j += 2 * i)
+        if (lpf[j / 2] == 0) lpf[j / 2] = i;
+  return lpf;
+}
+
+} // namespace detail
+
+// computed once per N and shared by everything below; ~1e5 stays inside the default constexpr budgets
+template <uint64_t N> inline constexpr auto cOddLpf = detail::odd_lpf_table<N>();
+
+template <uint64_t N> [[nodiscard]] consteval size_t sieve_prime_count()
+{
+  size_t count = N >= 2 ? 1 : 0;
+  for (uint64_t i = 3; i <= N; i += 2)
+    if (cOddLpf<N>[i / 2] == 0) count++;
+  return count;
+}
+
+template <size_t N> [[nodiscard]] consteval std::array<uint64_t, sieve_prime_count<N>()> primes_upto()
 {
-  std::array<uint64_t, prime_count(N)> primes{};
+  std::array<uint64_t, sieve_prime_count<N>()> primes{};
   size_t idx = 0;
-  for (size_t i = 2; i <= N; ++i)
-    if (is_prime(i)) primes[idx++] = i;
+  if (N >= 2) primes[idx++] = 2;
+  for (uint64_t i = 3; i <= N; i += 2)
+    if (cOddLpf<N>[i / 2] == 0) primes[idx++] = i;
   return primes;
 }
 